@@ -0,0 +1,104 @@
+#include "ubobj/CRT/CRTHitCollection.hh"
+
+#include <stdexcept>
+
+namespace crt {
+
+  CRTHitCollection::CRTHitCollection()
+  {
+    clear();
+  }
+
+  CRTHitCollection::CRTHitCollection(const std::vector<CRTHit>& hits)
+  {
+    clear();
+    reserve(hits.size());
+    for (auto const& hit : hits) push_back(hit);
+  }
+
+  void CRTHitCollection::clear()
+  {
+    peshit.clear(); ts0_s.clear(); ts0_s_corr.clear(); ts0_ns.clear(); ts0_ns_corr.clear(); ts1_ns.clear();
+    plane.clear();
+    x_pos.clear(); x_err.clear(); y_pos.clear(); y_err.clear(); z_pos.clear(); z_err.clear();
+    feb_id.clear(); pes_feb.clear(); pes_strip.clear(); pes_value.clear();
+    feb_begin.assign(1, 0);
+    pes_begin.assign(1, 0);
+    strip_begin.assign(1, 0);
+  }
+
+  void CRTHitCollection::reserve(size_t n)
+  {
+    peshit.reserve(n); ts0_s.reserve(n); ts0_s_corr.reserve(n); ts0_ns.reserve(n); ts0_ns_corr.reserve(n); ts1_ns.reserve(n);
+    plane.reserve(n);
+    x_pos.reserve(n); x_err.reserve(n); y_pos.reserve(n); y_err.reserve(n); z_pos.reserve(n); z_err.reserve(n);
+    feb_begin.reserve(n + 1);
+    pes_begin.reserve(n + 1);
+  }
+
+  void CRTHitCollection::push_back(const CRTHit& hit)
+  {
+    peshit.push_back(hit.peshit);
+    ts0_s.push_back(hit.ts0_s);
+    ts0_s_corr.push_back(hit.ts0_s_corr);
+    ts0_ns.push_back(hit.ts0_ns);
+    ts0_ns_corr.push_back(hit.ts0_ns_corr);
+    ts1_ns.push_back(hit.ts1_ns);
+    plane.push_back(hit.plane);
+    x_pos.push_back(hit.x_pos);
+    x_err.push_back(hit.x_err);
+    y_pos.push_back(hit.y_pos);
+    y_err.push_back(hit.y_err);
+    z_pos.push_back(hit.z_pos);
+    z_err.push_back(hit.z_err);
+
+    feb_id.insert(feb_id.end(), hit.feb_id.begin(), hit.feb_id.end());
+    feb_begin.push_back(feb_id.size());
+
+    for (auto const& entry : hit.pesmap) {
+      pes_feb.push_back(entry.first);
+      for (auto const& sp : entry.second) {
+        pes_strip.push_back(sp.first);
+        pes_value.push_back(sp.second);
+      }
+      strip_begin.push_back(pes_strip.size());
+    }
+    pes_begin.push_back(pes_feb.size());
+  }
+
+  CRTHit CRTHitCollection::at(size_t i) const
+  {
+    if (i >= size()) throw std::out_of_range("CRTHitCollection::at: index out of range");
+
+    CRTHit hit;
+    hit.peshit = peshit[i];
+    hit.ts0_s = ts0_s[i];
+    hit.ts0_s_corr = ts0_s_corr[i];
+    hit.ts0_ns = ts0_ns[i];
+    hit.ts0_ns_corr = ts0_ns_corr[i];
+    hit.ts1_ns = ts1_ns[i];
+    hit.plane = plane[i];
+    hit.x_pos = x_pos[i];
+    hit.x_err = x_err[i];
+    hit.y_pos = y_pos[i];
+    hit.y_err = y_err[i];
+    hit.z_pos = z_pos[i];
+    hit.z_err = z_err[i];
+
+    hit.feb_id.assign(feb_id.begin() + feb_begin[i], feb_id.begin() + feb_begin[i + 1]);
+    for (uint32_t e = pes_begin[i]; e < pes_begin[i + 1]; ++e) {
+      auto& strips = hit.pesmap[pes_feb[e]];
+      for (uint32_t s = strip_begin[e]; s < strip_begin[e + 1]; ++s) strips.emplace_back(pes_strip[s], pes_value[s]);
+    }
+    return hit;
+  }
+
+  std::vector<CRTHit> CRTHitCollection::toHits() const
+  {
+    std::vector<CRTHit> hits;
+    hits.reserve(size());
+    for (size_t i = 0; i < size(); ++i) hits.push_back(at(i));
+    return hits;
+  }
+
+}
@@ -0,0 +1,72 @@
+/**
+ * \class CRTHitCollection
+ *
+ * \ingroup crt
+ *
+ * \brief Columnar (structure-of-arrays) storage for many CRTHits
+ *
+ * One contiguous array per CRTHit scalar. The per-hit feb_id vectors and
+ * pesmap maps are flattened into shared arrays addressed by offsets:
+ *
+ *  - feb_id of hit i:  feb_id[feb_begin[i] .. feb_begin[i+1])
+ *  - pesmap of hit i:  entries pes_begin[i] .. pes_begin[i+1]), each entry
+ *    e has key pes_feb[e] and the (strip, pe) pairs
+ *    pes_strip/pes_value[strip_begin[e] .. strip_begin[e+1])
+ *
+ * A collection of N hits costs a fixed number of allocations instead of
+ * several per hit, and streams as a handful of basic-type arrays.
+ *
+ */
+
+
+#ifndef CRTHitCollection_hh_
+#define CRTHitCollection_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+
+namespace crt {
+
+  struct CRTHitCollection{
+    std::vector<float> peshit;
+    std::vector<uint32_t> ts0_s;
+    std::vector<int8_t> ts0_s_corr;
+    std::vector<uint32_t> ts0_ns;
+    std::vector<int32_t> ts0_ns_corr;
+    std::vector<int32_t> ts1_ns;
+    std::vector<int> plane;
+    std::vector<float> x_pos;
+    std::vector<float> x_err;
+    std::vector<float> y_pos;
+    std::vector<float> y_err;
+    std::vector<float> z_pos;
+    std::vector<float> z_err;
+
+    std::vector<uint32_t> feb_begin; // size()+1 offsets into feb_id
+    std::vector<uint8_t> feb_id;
+
+    std::vector<uint32_t> pes_begin; // size()+1 offsets into pes_feb/strip_begin
+    std::vector<uint8_t> pes_feb; // pesmap keys
+    std::vector<uint32_t> strip_begin; // pes_feb.size()+1 offsets into pes_strip/pes_value
+    std::vector<int> pes_strip;
+    std::vector<float> pes_value;
+
+    CRTHitCollection();
+    explicit CRTHitCollection(const std::vector<CRTHit>& hits);
+
+    size_t size() const { return plane.size(); }
+    bool empty() const { return plane.empty(); }
+    void clear();
+    void reserve(size_t n);
+
+    void push_back(const CRTHit& hit);
+    CRTHit at(size_t i) const; // rebuilds the CRTHit, including feb_id and pesmap
+    std::vector<CRTHit> toHits() const;
+
+  };
+
+}
+
+#endif
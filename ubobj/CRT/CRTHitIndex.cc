@@ -0,0 +1,115 @@
+#include "ubobj/CRT/CRTHitIndex.hh"
+#include "ubobj/CRT/CRTTime.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace crt {
+
+  CRTHitIndex::CRTHitIndex(const std::vector<CRTHit>& hits, float cellSize, TimeSource time)
+    : fCellSize(cellSize > 0 ? cellSize : 1.f)
+  {
+    fTime.reserve(hits.size());
+    fX.reserve(hits.size()); fY.reserve(hits.size()); fZ.reserve(hits.size());
+    for (size_t i = 0; i < hits.size(); ++i) {
+      const CRTHit& h = hits[i];
+      int64_t t = (time == kTs0) ? correctedTime(h) : int64_t(h.ts1_ns);
+      fTime.push_back(t);
+      fX.push_back(h.x_pos); fY.push_back(h.y_pos); fZ.push_back(h.z_pos);
+
+      Plane& p = fPlanes[h.plane];
+      Entry e{t, uint32_t(i)};
+      p.byTime.push_back(e);
+      p.cells[cellKey(cellCoord(h.x_pos), cellCoord(h.y_pos), cellCoord(h.z_pos))].push_back(e);
+    }
+
+    auto byT = [](const Entry& a, const Entry& b) { return a.t < b.t || (a.t == b.t && a.index < b.index); };
+    for (auto& pp : fPlanes) {
+      std::sort(pp.second.byTime.begin(), pp.second.byTime.end(), byT);
+      for (auto& c : pp.second.cells) std::sort(c.second.begin(), c.second.end(), byT);
+    }
+  }
+
+  uint64_t CRTHitIndex::cellKey(int64_t ix, int64_t iy, int64_t iz) const
+  {
+    // 21 bits per axis is far more than the detector needs at any sane cell size
+    const uint64_t m = (uint64_t(1) << 21) - 1;
+    return (uint64_t(ix) & m) | ((uint64_t(iy) & m) << 21) | ((uint64_t(iz) & m) << 42);
+  }
+
+  int64_t CRTHitIndex::cellCoord(float v) const
+  {
+    return int64_t(std::floor(v / fCellSize));
+  }
+
+  void CRTHitIndex::window(const std::vector<Entry>& entries, int64_t t, int64_t dt, std::vector<size_t>& out) const
+  {
+    auto lo = std::lower_bound(entries.begin(), entries.end(), t - dt, [](const Entry& e, int64_t v) { return e.t < v; });
+    for (auto it = lo; it != entries.end() && it->t <= t + dt; ++it) out.push_back(it->index);
+  }
+
+  std::vector<size_t> CRTHitIndex::inTimeWindow(int plane, int64_t t, int64_t dt) const
+  {
+    std::vector<size_t> out;
+    if (plane != kAnyPlane) {
+      auto it = fPlanes.find(plane);
+      if (it != fPlanes.end()) window(it->second.byTime, t, dt, out);
+      return out;
+    }
+    for (auto const& pp : fPlanes) window(pp.second.byTime, t, dt, out);
+    std::sort(out.begin(), out.end(), [this](size_t a, size_t b) { return fTime[a] < fTime[b] || (fTime[a] == fTime[b] && a < b); });
+    return out;
+  }
+
+  void CRTHitIndex::queryPlane(const Plane& p, int64_t t, int64_t dt, float x, float y, float z, float r, std::vector<size_t>& out) const
+  {
+    const float r2 = r * r;
+    auto accept = [&](const std::vector<Entry>& entries) {
+      auto lo = std::lower_bound(entries.begin(), entries.end(), t - dt, [](const Entry& e, int64_t v) { return e.t < v; });
+      for (auto it = lo; it != entries.end() && it->t <= t + dt; ++it) {
+        float dx = fX[it->index] - x, dy = fY[it->index] - y, dz = fZ[it->index] - z;
+        if (dx * dx + dy * dy + dz * dz <= r2) out.push_back(it->index);
+      }
+    };
+
+    int64_t x0 = cellCoord(x - r), x1 = cellCoord(x + r);
+    int64_t y0 = cellCoord(y - r), y1 = cellCoord(y + r);
+    int64_t z0 = cellCoord(z - r), z1 = cellCoord(z + r);
+    double nCells = double(x1 - x0 + 1) * double(y1 - y0 + 1) * double(z1 - z0 + 1);
+
+    if (nCells > double(p.cells.size())) {
+      // a sphere larger than the occupied region: cheaper to visit every occupied cell
+      for (auto const& c : p.cells) accept(c.second);
+      return;
+    }
+    for (int64_t ix = x0; ix <= x1; ++ix)
+      for (int64_t iy = y0; iy <= y1; ++iy)
+        for (int64_t iz = z0; iz <= z1; ++iz) {
+          auto it = p.cells.find(cellKey(ix, iy, iz));
+          if (it != p.cells.end()) accept(it->second);
+        }
+  }
+
+  std::vector<size_t> CRTHitIndex::query(int plane, int64_t t, int64_t dt, float x, float y, float z, float r) const
+  {
+    std::vector<size_t> out;
+    if (r < 0) return out;
+    if (plane != kAnyPlane) {
+      auto it = fPlanes.find(plane);
+      if (it != fPlanes.end()) queryPlane(it->second, t, dt, x, y, z, r, out);
+    }
+    else {
+      for (auto const& pp : fPlanes) queryPlane(pp.second, t, dt, x, y, z, r, out);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+  }
+
+  std::vector<int> CRTHitIndex::planes() const
+  {
+    std::vector<int> out;
+    for (auto const& pp : fPlanes) out.push_back(pp.first);
+    return out;
+  }
+
+}
@@ -0,0 +1,77 @@
+/**
+ * \class CRTHitIndex
+ *
+ * \ingroup crt
+ *
+ * \brief Per-event search index over a CRTHit collection
+ *
+ * Hits are bucketed by plane. Within a plane they are kept sorted by time
+ * (crt::correctedTime, the same 64-bit clock the matchers use, or ts1_ns)
+ * and also binned on a uniform x/y/z grid whose cells are themselves time
+ * sorted, so "hits on plane P within dt of T and within R of a point"
+ * visits only the cells the sphere touches and, inside each, only the hits
+ * in the time window. The index copies the times and positions it
+ * needs, so it does not refer to the hit collection after construction;
+ * the indices it returns are positions in the collection as indexed.
+ *
+ */
+
+
+#ifndef CRTHitIndex_hh_
+#define CRTHitIndex_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+
+namespace crt {
+
+  class CRTHitIndex{
+    public:
+    enum TimeSource { kTs0, kTs1 };
+    // plane wildcard; any other value, including -1 (unknown plane, e.g. from
+    // CRTSimDigitizer), selects the hits on exactly that plane
+    static constexpr int kAnyPlane = std::numeric_limits<int>::min();
+
+    // cellSize in cm; time from crt::correctedTime (kTs0) or ts1_ns (kTs1)
+    CRTHitIndex(const std::vector<CRTHit>& hits, float cellSize=50., TimeSource time=kTs0);
+
+    // indices of hits on plane (or any plane) with |t_hit - t| <= dt, in time order
+    std::vector<size_t> inTimeWindow(int plane, int64_t t, int64_t dt) const;
+    // same, restricted to hits within r of (x,y,z); in increasing index order
+    std::vector<size_t> query(int plane, int64_t t, int64_t dt, float x, float y, float z, float r) const;
+
+    int64_t hitTime(size_t i) const { return fTime[i]; }
+    size_t size() const { return fTime.size(); }
+    std::vector<int> planes() const;
+
+    private:
+    struct Entry{
+      int64_t t;
+      uint32_t index;
+    };
+
+    struct Plane{
+      std::vector<Entry> byTime;
+      std::unordered_map<uint64_t, std::vector<Entry> > cells; // each cell sorted by time
+    };
+
+    uint64_t cellKey(int64_t ix, int64_t iy, int64_t iz) const;
+    int64_t cellCoord(float v) const;
+    void window(const std::vector<Entry>& entries, int64_t t, int64_t dt, std::vector<size_t>& out) const;
+    void queryPlane(const Plane& p, int64_t t, int64_t dt, float x, float y, float z, float r, std::vector<size_t>& out) const;
+
+    float fCellSize;
+    std::vector<int64_t> fTime; // hit time used for indexing, by hit index
+    std::vector<float> fX, fY, fZ; // hit position, by hit index
+    std::map<int, Plane> fPlanes;
+
+  };
+
+}
+
+#endif
@@ -43,18 +43,6 @@ namespace crt {
   };  //end class definition
 
 
-  CRTSimData::CRTSimData(): fChannel(0), fT0(0), fT1(0), fADC(0), fTrackID(-1){
-  }
-  CRTSimData::CRTSimData(uint32_t channel, uint32_t t0, 
-			 uint32_t t1, uint32_t adc,int trackID):
-    fChannel(channel),
-    fT0(t0),
-    fT1(t1),
-    fADC(adc), 
-    fTrackID(trackID) {
-    }
-  CRTSimData::~CRTSimData() {
-  }
   /*
   uint32_t CRTSimData::Channel() const { 
     return fChannel;
@@ -0,0 +1,130 @@
+#include "ubobj/CRT/CRTSimDigitizer.hh"
+
+#include <algorithm>
+
+namespace crt {
+
+  void CRTSimChannelData::clear()
+  {
+    channel.clear();
+    begin.assign(1, 0);
+    t0.clear();
+    t1.clear();
+    adc.clear();
+    trackID.clear();
+    source.clear();
+  }
+
+  CRTSimDigitizer::CRTSimDigitizer(const CRTSimDigitizerConfig& cfg)
+    : fConfig(cfg)
+  {
+    if (fConfig.channelsPerFEB == 0) fConfig.channelsPerFEB = 1;
+    if (fConfig.gain == 0) fConfig.gain = 1;
+  }
+
+  std::vector<uint32_t> CRTSimDigitizer::radixOrder(const std::vector<uint64_t>& keys)
+  {
+    const size_t n = keys.size();
+    std::vector<uint32_t> order(n), tmp(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+
+    uint64_t all = 0;
+    for (uint64_t k : keys) all |= k;
+
+    std::vector<uint32_t> count(1 << 16);
+    for (unsigned shift = 0; shift < 64; shift += 16) {
+      if (((all >> shift) & 0xFFFF) == 0) continue; // digit is zero everywhere
+      std::fill(count.begin(), count.end(), 0);
+      for (size_t i = 0; i < n; ++i) ++count[(keys[i] >> shift) & 0xFFFF];
+      uint32_t sum = 0;
+      for (auto& c : count) {
+        uint32_t next = sum + c;
+        c = sum;
+        sum = next;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        uint32_t idx = order[i];
+        tmp[count[(keys[idx] >> shift) & 0xFFFF]++] = idx;
+      }
+      order.swap(tmp);
+    }
+    return order;
+  }
+
+  void CRTSimDigitizer::sortByChannel(const std::vector<CRTSimData>& data, CRTSimChannelData& out)
+  {
+    out.clear();
+    std::vector<uint64_t> keys;
+    keys.reserve(data.size());
+    for (auto const& d : data) keys.push_back((uint64_t(d.fChannel) << 32) | d.fT0);
+    std::vector<uint32_t> order = radixOrder(keys);
+
+    out.t0.reserve(data.size());
+    out.t1.reserve(data.size());
+    out.adc.reserve(data.size());
+    out.trackID.reserve(data.size());
+    out.source.reserve(data.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+      const CRTSimData& d = data[order[k]];
+      if (out.channel.empty() || out.channel.back() != d.fChannel) {
+        if (!out.channel.empty()) out.begin.push_back(k);
+        out.channel.push_back(d.fChannel);
+      }
+      out.t0.push_back(d.fT0);
+      out.t1.push_back(d.fT1);
+      out.adc.push_back(d.fADC);
+      out.trackID.push_back(d.fTrackID);
+      out.source.push_back(order[k]);
+    }
+    if (!out.channel.empty()) out.begin.push_back(order.size());
+  }
+
+  std::vector<CRTHit> CRTSimDigitizer::makeHits(const std::vector<CRTSimData>& data) const
+  {
+    // (FEB, T0) order, keeping only samples above threshold
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> index;
+    keys.reserve(data.size());
+    index.reserve(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      const CRTSimData& d = data[i];
+      if ((float(d.fADC) - fConfig.pedestal) / fConfig.gain < fConfig.minPE) continue;
+      keys.push_back((uint64_t(d.fChannel / fConfig.channelsPerFEB) << 32) | d.fT0);
+      index.push_back(i);
+    }
+    std::vector<uint32_t> order = radixOrder(keys);
+
+    std::vector<CRTHit> hits;
+    size_t first = 0;
+    while (first < order.size()) {
+      const CRTSimData& d0 = data[index[order[first]]];
+      const uint32_t feb = d0.fChannel / fConfig.channelsPerFEB;
+
+      CRTHit hit;
+      hit.feb_id.push_back(uint8_t(feb));
+      auto& strips = hit.pesmap[uint8_t(feb)];
+      hit.peshit = 0;
+      hit.ts0_s = 0;
+      hit.ts0_s_corr = 0;
+      hit.ts0_ns = d0.fT0;
+      hit.ts0_ns_corr = 0;
+      hit.ts1_ns = int32_t(d0.fT1);
+      hit.plane = kUnknownPlane;
+      hit.x_pos = hit.x_err = hit.y_pos = hit.y_err = hit.z_pos = hit.z_err = 0;
+
+      size_t last = first;
+      for (; last < order.size(); ++last) {
+        const CRTSimData& d = data[index[order[last]]];
+        if (d.fChannel / fConfig.channelsPerFEB != feb || d.fT0 - d0.fT0 > fConfig.window_ns) break;
+        float pe = (float(d.fADC) - fConfig.pedestal) / fConfig.gain;
+        strips.emplace_back(int(d.fChannel % fConfig.channelsPerFEB), pe);
+        hit.peshit += pe;
+        hit.ts1_ns = std::min(hit.ts1_ns, int32_t(d.fT1));
+      }
+      hits.push_back(std::move(hit));
+      first = last;
+    }
+    return hits;
+  }
+
+}
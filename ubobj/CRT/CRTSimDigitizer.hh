@@ -0,0 +1,78 @@
+/**
+ * \class CRTSimDigitizer
+ *
+ * \ingroup crt
+ *
+ * \brief Batch conversion of CRTSimData into channel-sorted arrays and CRTHit candidates
+ *
+ * sortByChannel() orders a whole vector of CRTSimData by (channel, T0) with
+ * an LSD radix sort on a packed 64-bit key, which is linear in the number of
+ * samples, and returns the result as per-channel time-ordered columns.
+ *
+ * makeHits() groups the samples of each FEB (channel / channelsPerFEB) that
+ * fall within window_ns of the first one into a CRTHit candidate: feb_id
+ * holds the FEB, pesmap[feb] the (strip, pe) pairs, peshit their sum, and
+ * ts0_ns/ts1_ns the earliest T0/T1. Positions need the detector geometry,
+ * so plane is kUnknownPlane (-1) and the positions are zero until the
+ * caller fills them; CRTHitIndex treats -1 as an ordinary plane, not as
+ * its wildcard.
+ *
+ */
+
+
+#ifndef CRTSimDigitizer_hh_
+#define CRTSimDigitizer_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+#include "ubobj/CRT/CRTSimData.hh"
+
+namespace crt {
+
+  struct CRTSimChannelData{
+    std::vector<uint32_t> channel; // distinct channels, ascending
+    std::vector<uint32_t> begin; // channel.size()+1 offsets into the sample arrays
+
+    // samples sorted by (channel, T0)
+    std::vector<uint32_t> t0;
+    std::vector<uint32_t> t1;
+    std::vector<uint32_t> adc;
+    std::vector<int> trackID;
+    std::vector<uint32_t> source; // index of the sample in the input vector
+
+    size_t nSamples() const { return t0.size(); }
+    void clear();
+  };
+
+  struct CRTSimDigitizerConfig{
+    uint32_t channelsPerFEB = 32;
+    uint32_t window_ns = 100; // coincidence window within one FEB
+    float pedestal = 0; // pe = (adc - pedestal) / gain
+    float gain = 1;
+    float minPE = 0; // samples below this are dropped from the candidates
+  };
+
+  class CRTSimDigitizer{
+    public:
+    static constexpr int kUnknownPlane = -1; // CRTHit::plane of the candidates
+
+    explicit CRTSimDigitizer(const CRTSimDigitizerConfig& cfg=CRTSimDigitizerConfig());
+
+    static void sortByChannel(const std::vector<CRTSimData>& data, CRTSimChannelData& out);
+    std::vector<CRTHit> makeHits(const std::vector<CRTSimData>& data) const;
+
+    // stable LSD radix sort of keys, 16 bits per pass; returns the sorted order
+    static std::vector<uint32_t> radixOrder(const std::vector<uint64_t>& keys);
+
+    const CRTSimDigitizerConfig& config() const { return fConfig; }
+
+    private:
+    CRTSimDigitizerConfig fConfig;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "ubobj/CRT/CRTTPCMatcher.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace crt {
+
+  void dcaToLine(const CRTTPCLine& line, const float* x, const float* y, const float* z, size_t n, float* dca)
+  {
+    // unit direction; a degenerate line becomes a point
+    float norm = std::sqrt(line.dx * line.dx + line.dy * line.dy + line.dz * line.dz);
+    float inv = norm > 0 ? 1.f / norm : 0.f;
+    const float ux = line.dx * inv, uy = line.dy * inv, uz = line.dz * inv;
+
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256 ax = _mm256_set1_ps(line.x), ay = _mm256_set1_ps(line.y), az = _mm256_set1_ps(line.z);
+    const __m256 vux = _mm256_set1_ps(ux), vuy = _mm256_set1_ps(uy), vuz = _mm256_set1_ps(uz);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+      __m256 vx = _mm256_sub_ps(_mm256_loadu_ps(x + i), ax);
+      __m256 vy = _mm256_sub_ps(_mm256_loadu_ps(y + i), ay);
+      __m256 vz = _mm256_sub_ps(_mm256_loadu_ps(z + i), az);
+      __m256 proj = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vux), _mm256_mul_ps(vy, vuy)), _mm256_mul_ps(vz, vuz));
+      __m256 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+      __m256 perp2 = _mm256_max_ps(_mm256_sub_ps(r2, _mm256_mul_ps(proj, proj)), zero);
+      _mm256_storeu_ps(dca + i, _mm256_sqrt_ps(perp2));
+    }
+#endif
+    for (; i < n; ++i) {
+      const float vx = x[i] - line.x, vy = y[i] - line.y, vz = z[i] - line.z;
+      const float proj = vx * ux + vy * uy + vz * uz;
+      const float r2 = vx * vx + vy * vy + vz * vz;
+      dca[i] = std::sqrt(std::max(r2 - proj * proj, 0.f));
+    }
+  }
+
+  void inTimeWindow(int64_t t, int64_t window, const int64_t* times, size_t n, uint8_t* pass)
+  {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i vt = _mm256_set1_epi64x(t), hi = _mm256_set1_epi64x(window), lo = _mm256_set1_epi64x(-window);
+    for (; i + 4 <= n; i += 4) {
+      __m256i d = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(times + i)), vt);
+      __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(d, hi), _mm256_cmpgt_epi64(lo, d));
+      int m = _mm256_movemask_pd(_mm256_castsi256_pd(outside));
+      for (int k = 0; k < 4; ++k) pass[i + k] = !((m >> k) & 1);
+    }
+#endif
+    for (; i < n; ++i) {
+      // wrap like the vector lanes instead of overflowing
+      const int64_t d = int64_t(uint64_t(times[i]) - uint64_t(t));
+      pass[i] = d <= window && d >= -window;
+    }
+  }
+
+  CRTTPCMatcher::CRTTPCMatcher(const CRTTPCMatcherConfig& cfg)
+    : fConfig(cfg)
+  {}
+
+  void CRTTPCMatcher::match(size_t track, const CRTTPCLine& line, const CRTHitCollection& hits, const std::vector<int64_t>& hitTimes,
+                            const std::vector<size_t>* candidates, std::vector<CRTTPCMatch>& out) const
+  {
+    const size_t n = candidates ? candidates->size() : hits.size();
+    if (n == 0) return;
+
+    // gather the candidates into a contiguous block; all hits are contiguous already
+    std::vector<float> gx, gy, gz;
+    std::vector<int64_t> gt;
+    const float *x = hits.x_pos.data(), *y = hits.y_pos.data(), *z = hits.z_pos.data();
+    const int64_t* t = hitTimes.data();
+    if (candidates) {
+      gx.reserve(n); gy.reserve(n); gz.reserve(n); gt.reserve(n);
+      for (size_t c : *candidates) {
+        gx.push_back(hits.x_pos[c]);
+        gy.push_back(hits.y_pos[c]);
+        gz.push_back(hits.z_pos[c]);
+        gt.push_back(hitTimes[c]);
+      }
+      x = gx.data(); y = gy.data(); z = gz.data(); t = gt.data();
+    }
+
+    std::vector<float> dca(n);
+    std::vector<uint8_t> inTime(n, 1);
+    dcaToLine(line, x, y, z, n, dca.data());
+    if (fConfig.useTime) inTimeWindow(line.t_ns, fConfig.timeWindow_ns, t, n, inTime.data());
+
+    for (size_t k = 0; k < n; ++k) {
+      if (!inTime[k]) continue;
+      const size_t h = candidates ? (*candidates)[k] : k;
+      float cut = fConfig.maxDCA;
+      if (fConfig.nSigma > 0) {
+        cut += fConfig.nSigma * std::sqrt(hits.x_err[h] * hits.x_err[h] + hits.y_err[h] * hits.y_err[h] + hits.z_err[h] * hits.z_err[h]);
+      }
+      if (dca[k] <= cut) out.push_back(CRTTPCMatch{track, h, dca[k]});
+    }
+  }
+
+  void CRTTPCMatcher::match(size_t track, const CRTTPCLine& line, const std::vector<CRTTrack>& crtTracks, const std::vector<int64_t>& trackTimes,
+                            std::vector<CRTTPCMatch>& out) const
+  {
+    const size_t n = crtTracks.size();
+    if (n == 0) return;
+
+    // endpoints 1 in [0,n), endpoints 2 in [n,2n)
+    std::vector<float> x(2 * n), y(2 * n), z(2 * n), dca(2 * n);
+    for (size_t k = 0; k < n; ++k) {
+      const CRTTrack& tr = crtTracks[k];
+      x[k] = tr.x1_pos; y[k] = tr.y1_pos; z[k] = tr.z1_pos;
+      x[n + k] = tr.x2_pos; y[n + k] = tr.y2_pos; z[n + k] = tr.z2_pos;
+    }
+    std::vector<uint8_t> inTime(n, 1);
+    dcaToLine(line, x.data(), y.data(), z.data(), 2 * n, dca.data());
+    if (fConfig.useTime) inTimeWindow(line.t_ns, fConfig.timeWindow_ns, trackTimes.data(), n, inTime.data());
+
+    for (size_t k = 0; k < n; ++k) {
+      if (!inTime[k]) continue;
+      const CRTTrack& tr = crtTracks[k];
+      float cut1 = fConfig.maxDCA, cut2 = fConfig.maxDCA;
+      if (fConfig.nSigma > 0) {
+        cut1 += fConfig.nSigma * std::sqrt(tr.x1_err * tr.x1_err + tr.y1_err * tr.y1_err + tr.z1_err * tr.z1_err);
+        cut2 += fConfig.nSigma * std::sqrt(tr.x2_err * tr.x2_err + tr.y2_err * tr.y2_err + tr.z2_err * tr.z2_err);
+      }
+      if (dca[k] <= cut1 && dca[n + k] <= cut2) out.push_back(CRTTPCMatch{track, k, std::max(dca[k], dca[n + k])});
+    }
+  }
+
+}
@@ -0,0 +1,89 @@
+/**
+ * \class CRTTPCMatcher
+ *
+ * \ingroup crt
+ *
+ * \brief Distance-of-closest-approach matching of one TPC track to a block of CRT hits
+ *
+ * A TPC track is reduced to a line (a point, a direction and a time). The
+ * kernels evaluate, for a whole structure-of-arrays block of CRT hits, the
+ * distance from each hit position to the line and whether the hit time lies
+ * within a window of the track time. They use AVX2 when the library is
+ * built with it (-mavx2 or a -march that implies it) and a scalar loop
+ * otherwise; the two agree to float rounding.
+ *
+ * All times are on one clock, the corrected 64-bit nanoseconds of
+ * crt::correctedTime: the hit times passed to match(), the times
+ * CRTHitIndex sorts on (kTs0), and crt::absoluteTime of the CRTTracks and
+ * CRTTzeros that CRTTrackBuilder and CRTTzeroClusterer make from corrected
+ * hit times. The track time in CRTTPCLine must be on it too.
+ *
+ * match() takes an optional candidate list, typically from
+ * CRTHitIndex::inTimeWindow or CRTHitIndex::query, so a coarse plane/time
+ * prefilter and the exact kernel combine. Matches come out as
+ * (track index, CRT index, dca) triples. This library does not depend on
+ * art or recob::Track, so turning the triples into
+ * art::Assns<recob::Track,crt::CRTHit> or art::Assns<recob::Track,crt::CRTTrack>
+ * is left to the producer that owns the Ptrs.
+ *
+ */
+
+
+#ifndef CRTTPCMatcher_hh_
+#define CRTTPCMatcher_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ubobj/CRT/CRTHitCollection.hh"
+#include "ubobj/CRT/CRTTrack.hh"
+
+namespace crt {
+
+  struct CRTTPCLine{
+    float x, y, z; // a point on the track, cm
+    float dx, dy, dz; // direction; need not be normalised
+    int64_t t_ns; // track time, on the same clock as the CRT times it is compared to
+  };
+
+  struct CRTTPCMatch{
+    size_t track;
+    size_t crt; // index of the CRTHit or CRTTrack
+    float dca; // cm; for a CRTTrack the larger of its two endpoints
+  };
+
+  struct CRTTPCMatcherConfig{
+    float maxDCA = 50; // cm
+    float nSigma = 0; // widen the cut by nSigma times the hit (or track endpoint) position error
+    int64_t timeWindow_ns = 1000;
+    bool useTime = true;
+  };
+
+  // kernels: dca[i] = distance from (x[i],y[i],z[i]) to the line;
+  // pass[i] = 1 if |times[i] - t| <= window, else 0
+  void dcaToLine(const CRTTPCLine& line, const float* x, const float* y, const float* z, size_t n, float* dca);
+  void inTimeWindow(int64_t t, int64_t window, const int64_t* times, size_t n, uint8_t* pass);
+
+  class CRTTPCMatcher{
+    public:
+    explicit CRTTPCMatcher(const CRTTPCMatcherConfig& cfg=CRTTPCMatcherConfig());
+
+    // hitTimes index-aligned with hits (e.g. from crt::correctedTimes); candidates
+    // restricts the hits looked at, nullptr means all. Matches are appended to out.
+    void match(size_t track, const CRTTPCLine& line, const CRTHitCollection& hits, const std::vector<int64_t>& hitTimes,
+               const std::vector<size_t>* candidates, std::vector<CRTTPCMatch>& out) const;
+    // both CRTTrack endpoints must be within the cut, each widened by its own position
+    // error; trackTimes index-aligned with crtTracks (e.g. from crt::absoluteTimes)
+    void match(size_t track, const CRTTPCLine& line, const std::vector<CRTTrack>& crtTracks, const std::vector<int64_t>& trackTimes,
+               std::vector<CRTTPCMatch>& out) const;
+
+    const CRTTPCMatcherConfig& config() const { return fConfig; }
+
+    private:
+    CRTTPCMatcherConfig fConfig;
+
+  };
+
+}
+
+#endif
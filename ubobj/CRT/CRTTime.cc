@@ -0,0 +1,35 @@
+#include "ubobj/CRT/CRTTime.hh"
+
+namespace crt {
+
+  void correctedTimes(const std::vector<CRTHit>& hits, std::vector<int64_t>& out)
+  {
+    out.resize(hits.size());
+    for (size_t i = 0; i < hits.size(); ++i) out[i] = correctedTime(hits[i]);
+  }
+
+  void correctedTimes(const CRTHitCollection& hits, std::vector<int64_t>& out)
+  {
+    const size_t n = hits.size();
+    out.resize(n);
+    const uint32_t* s = hits.ts0_s.data();
+    const int8_t* s_corr = hits.ts0_s_corr.data();
+    const uint32_t* ns = hits.ts0_ns.data();
+    const int32_t* ns_corr = hits.ts0_ns_corr.data();
+    int64_t* t = out.data();
+    for (size_t i = 0; i < n; ++i) t[i] = correctedTime(s[i], s_corr[i], ns[i], ns_corr[i]);
+  }
+
+  void absoluteTimes(const std::vector<CRTTrack>& tracks, std::vector<int64_t>& out)
+  {
+    out.resize(tracks.size());
+    for (size_t i = 0; i < tracks.size(); ++i) out[i] = absoluteTime(tracks[i]);
+  }
+
+  void absoluteTimes(const std::vector<CRTTzero>& tzeros, std::vector<int64_t>& out)
+  {
+    out.resize(tzeros.size());
+    for (size_t i = 0; i < tzeros.size(); ++i) out[i] = absoluteTime(tzeros[i]);
+  }
+
+}
@@ -0,0 +1,87 @@
+/**
+ * \class CRTTime
+ *
+ * \ingroup crt
+ *
+ * \brief Corrected 64-bit CRT timestamps
+ *
+ * CRT times come split into seconds and nanoseconds, plus separate
+ * corrections for each. These helpers fold them into one signed 64-bit
+ * nanosecond count:
+ *
+ *   CRTHit:            (ts0_s + ts0_s_corr) * 1e9 + ts0_ns + ts0_ns_corr
+ *   CRTTrack/CRTTzero: ts0_s * 1e9 + ts0_ns
+ *
+ * CRTTrackBuilder and CRTTzeroClusterer fill the track and tzero times
+ * from corrected hit times, so for their output both are the same clock.
+ *
+ * Every term is widened to int64_t before the arithmetic, so negative
+ * corrections and large seconds counts cannot wrap. The batch versions are
+ * plain loops over contiguous inputs that the compiler vectorizes; the
+ * CRTHitCollection overload is the fast one, since its columns are already
+ * contiguous. Code that needs a time more than once per object computes
+ * the times into an array with them and reads that, rather than storing
+ * derived times in the data products.
+ *
+ */
+
+
+#ifndef CRTTime_hh_
+#define CRTTime_hh_
+
+#include <cstdint>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+#include "ubobj/CRT/CRTHitCollection.hh"
+#include "ubobj/CRT/CRTTrack.hh"
+#include "ubobj/CRT/CRTTzero.hh"
+
+namespace crt {
+
+  constexpr int64_t kNsPerSecond = 1000000000;
+
+  constexpr int64_t absoluteTime(uint32_t s, uint32_t ns)
+  {
+    return int64_t(s) * kNsPerSecond + int64_t(ns);
+  }
+
+  constexpr int64_t correctedTime(uint32_t s, int8_t s_corr, uint32_t ns, int32_t ns_corr)
+  {
+    return (int64_t(s) + int64_t(s_corr)) * kNsPerSecond + int64_t(ns) + int64_t(ns_corr);
+  }
+
+  // split a time back into s/ns; ns is always in [0, 1e9), also for negative times
+  constexpr int64_t nanosecondsOf(int64_t t)
+  {
+    return ((t % kNsPerSecond) + kNsPerSecond) % kNsPerSecond;
+  }
+
+  constexpr int64_t secondsOf(int64_t t)
+  {
+    return (t - nanosecondsOf(t)) / kNsPerSecond;
+  }
+
+  inline int64_t correctedTime(const CRTHit& hit)
+  {
+    return correctedTime(hit.ts0_s, hit.ts0_s_corr, hit.ts0_ns, hit.ts0_ns_corr);
+  }
+
+  inline int64_t absoluteTime(const CRTTrack& track)
+  {
+    return absoluteTime(track.ts0_s, track.ts0_ns);
+  }
+
+  inline int64_t absoluteTime(const CRTTzero& tzero)
+  {
+    return absoluteTime(tzero.ts0_s, tzero.ts0_ns);
+  }
+
+  // batch versions; out is resized to the input size
+  void correctedTimes(const std::vector<CRTHit>& hits, std::vector<int64_t>& out);
+  void correctedTimes(const CRTHitCollection& hits, std::vector<int64_t>& out);
+  void absoluteTimes(const std::vector<CRTTrack>& tracks, std::vector<int64_t>& out);
+  void absoluteTimes(const std::vector<CRTTzero>& tzeros, std::vector<int64_t>& out);
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include "ubobj/CRT/CRTTrackBuilder.hh"
+#include "ubobj/CRT/CRTTime.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  uint16_t halfDifference(int64_t a, int64_t b)
+  {
+    int64_t d = (a > b ? a - b : b - a) / 2;
+    return d > 65535 ? 65535 : uint16_t(d);
+  }
+
+}
+
+namespace crt {
+
+  CRTTrackBuilder::CRTTrackBuilder(const CRTTrackBuilderConfig& cfg)
+    : fConfig(cfg)
+  {}
+
+  int64_t CRTTrackBuilder::hitTime(const CRTHit& hit) const
+  {
+    if (fConfig.useTs1) return hit.ts1_ns;
+    return correctedTime(hit);
+  }
+
+  std::vector<size_t> CRTTrackBuilder::timeOrder(const std::vector<CRTHit>& hits) const
+  {
+    std::vector<std::pair<int64_t, size_t> > keyed;
+    keyed.reserve(hits.size());
+    for (size_t i = 0; i < hits.size(); ++i) {
+      if (hits[i].peshit >= fConfig.minPE) keyed.emplace_back(hitTime(hits[i]), i);
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<size_t> order;
+    order.reserve(keyed.size());
+    for (auto const& k : keyed) order.push_back(k.second);
+    return order;
+  }
+
+  std::vector<std::pair<size_t,size_t> > CRTTrackBuilder::slices(size_t n, size_t nSlices)
+  {
+    std::vector<std::pair<size_t,size_t> > out;
+    if (nSlices == 0) nSlices = 1;
+    for (size_t s = 0; s < nSlices; ++s) {
+      size_t begin = n * s / nSlices, end = n * (s + 1) / nSlices;
+      if (begin < end) out.emplace_back(begin, end);
+    }
+    return out;
+  }
+
+  std::vector<CRTTrack> CRTTrackBuilder::buildSlice(const std::vector<CRTHit>& hits, const std::vector<size_t>& order,
+                                                    size_t begin, size_t end, std::vector<std::pair<size_t,size_t> >* pairs) const
+  {
+    std::vector<CRTTrack> tracks;
+    end = std::min(end, order.size());
+    // times[k - begin] of hits[order[k]], each computed once as the window reaches it
+    std::vector<int64_t> times;
+    auto timeAt = [&](size_t k) {
+      while (times.size() <= k - begin) times.push_back(hitTime(hits[order[begin + times.size()]]));
+      return times[k - begin];
+    };
+    for (size_t a = begin; a < end; ++a) {
+      const CRTHit& h1 = hits[order[a]];
+      const int64_t t1 = timeAt(a);
+      // partners may lie past the end of the slice
+      for (size_t b = a + 1; b < order.size(); ++b) {
+        const CRTHit& h2 = hits[order[b]];
+        if (timeAt(b) - t1 > fConfig.window_ns) break;
+        if (h2.plane == h1.plane) continue;
+        tracks.push_back(makeTrack(h1, h2));
+        if (pairs) pairs->emplace_back(order[a], order[b]);
+      }
+    }
+    return tracks;
+  }
+
+  std::vector<CRTTrack> CRTTrackBuilder::build(const std::vector<CRTHit>& hits, std::vector<std::pair<size_t,size_t> >* pairs) const
+  {
+    std::vector<size_t> order = timeOrder(hits);
+    return buildSlice(hits, order, 0, order.size(), pairs);
+  }
+
+  CRTTrack CRTTrackBuilder::makeTrack(const CRTHit& hit1, const CRTHit& hit2)
+  {
+    CRTTrack tr;
+    tr.feb_id = hit1.feb_id;
+    tr.feb_id.insert(tr.feb_id.end(), hit2.feb_id.begin(), hit2.feb_id.end());
+    tr.pesmap = hit1.pesmap;
+    for (auto const& entry : hit2.pesmap) {
+      auto& strips = tr.pesmap[entry.first];
+      strips.insert(strips.end(), entry.second.begin(), entry.second.end());
+    }
+    tr.peshit = hit1.peshit + hit2.peshit;
+
+    // mean of the corrected times, taken relative to hit 1 so a pair across a
+    // second boundary averages correctly, then split back into s/ns
+    const int64_t ref = correctedTime(hit1), t2 = correctedTime(hit2);
+    const int64_t mean = ref + (t2 - ref) / 2;
+    tr.ts0_s = uint32_t(secondsOf(mean));
+    tr.ts0_s_err = 0;
+    tr.ts0_ns = uint32_t(nanosecondsOf(mean));
+    tr.ts0_ns_err = halfDifference(ref, t2);
+    tr.ts1_ns = int32_t((int64_t(hit1.ts1_ns) + int64_t(hit2.ts1_ns)) / 2);
+    tr.ts1_ns_err = halfDifference(hit1.ts1_ns, hit2.ts1_ns);
+
+    tr.plane1 = hit1.plane;
+    tr.plane2 = hit2.plane;
+    tr.x1_pos = hit1.x_pos; tr.x1_err = hit1.x_err;
+    tr.y1_pos = hit1.y_pos; tr.y1_err = hit1.y_err;
+    tr.z1_pos = hit1.z_pos; tr.z1_err = hit1.z_err;
+    tr.x2_pos = hit2.x_pos; tr.x2_err = hit2.x_err;
+    tr.y2_pos = hit2.y_pos; tr.y2_err = hit2.y_err;
+    tr.z2_pos = hit2.z_pos; tr.z2_err = hit2.z_err;
+
+    const float dx = hit2.x_pos - hit1.x_pos;
+    const float dy = hit2.y_pos - hit1.y_pos;
+    const float dz = hit2.z_pos - hit1.z_pos;
+    tr.length = std::sqrt(dx * dx + dy * dy + dz * dz);
+    tr.thetaxy = std::atan2(dy, dx);
+    tr.phizy = std::atan2(dy, dz);
+
+    tr.ts0_ns_h1 = uint32_t(nanosecondsOf(ref));
+    tr.ts0_ns_err_h1 = 0; // CRTHit carries no time uncertainty
+    tr.ts0_ns_h2 = uint32_t(nanosecondsOf(t2));
+    tr.ts0_ns_err_h2 = 0;
+    return tr;
+  }
+
+}
@@ -0,0 +1,76 @@
+/**
+ * \class CRTTrackBuilder
+ *
+ * \ingroup crt
+ *
+ * \brief Pairs coincident CRTHits on different planes into CRTTracks
+ *
+ * Hits are put in time order once; every hit is then paired with the
+ * later hits on other planes that fall inside the coincidence window, using
+ * a sliding window over the sorted hits. The cost is the sort plus one step
+ * per pair considered, instead of a loop over all hit pairs.
+ *
+ * Each pair belongs to its earlier hit, so the sorted hits can be cut into
+ * slices and the slices built independently (e.g. as TBB tasks): a slice
+ * reads past its end for partners but only emits pairs whose first hit lies
+ * inside it. Concatenating the slices' output in order gives exactly the
+ * output of build().
+ *
+ * Track conventions: hit 1 is the earlier hit; ts0_s/ts0_ns hold the mean
+ * of the two hits' corrected times (crt::correctedTime), so the track's
+ * absoluteTime is on the same clock as the hits', and ts0_s_err is 0;
+ * ts0_ns_h1/ts0_ns_h2 are the hits' corrected times within their second;
+ * ts1_ns is the mean of the hits' ts1_ns; the _ns_err fields are half the
+ * difference (saturating at 65535); length is the hit-to-hit distance;
+ * thetaxy = atan2(dy, dx) and phizy = atan2(dy, dz) in radians, with
+ * d = hit2 - hit1.
+ *
+ */
+
+
+#ifndef CRTTrackBuilder_hh_
+#define CRTTrackBuilder_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+#include "ubobj/CRT/CRTTrack.hh"
+
+namespace crt {
+
+  struct CRTTrackBuilderConfig{
+    int64_t window_ns = 100; // maximum time difference between the two hits
+    bool useTs1 = false; // pair on ts1_ns (beam-relative) instead of the corrected ts0 time (CRTTime.hh)
+    float minPE = 0; // ignore hits with peshit below this
+  };
+
+  class CRTTrackBuilder{
+    public:
+    explicit CRTTrackBuilder(const CRTTrackBuilderConfig& cfg=CRTTrackBuilderConfig());
+
+    // hits in any order; tracks in order of their first hit. If pairs is given it
+    // receives the (hit1, hit2) indices of every track, for building associations.
+    std::vector<CRTTrack> build(const std::vector<CRTHit>& hits, std::vector<std::pair<size_t,size_t> >* pairs=nullptr) const;
+
+    // sliced operation: sort once, then build [begin,end) ranges of the order
+    // from any thread; the builder holds no mutable state
+    std::vector<size_t> timeOrder(const std::vector<CRTHit>& hits) const; // hits passing minPE, sorted by time
+    static std::vector<std::pair<size_t,size_t> > slices(size_t n, size_t nSlices);
+    std::vector<CRTTrack> buildSlice(const std::vector<CRTHit>& hits, const std::vector<size_t>& order,
+                                     size_t begin, size_t end, std::vector<std::pair<size_t,size_t> >* pairs=nullptr) const;
+
+    int64_t hitTime(const CRTHit& hit) const; // the time pairing uses, in ns
+    static CRTTrack makeTrack(const CRTHit& hit1, const CRTHit& hit2);
+
+    const CRTTrackBuilderConfig& config() const { return fConfig; }
+
+    private:
+    CRTTrackBuilderConfig fConfig;
+
+  };
+
+}
+
+#endif
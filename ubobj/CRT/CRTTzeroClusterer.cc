@@ -0,0 +1,96 @@
+#include "ubobj/CRT/CRTTzeroClusterer.hh"
+#include "ubobj/CRT/CRTTime.hh"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+  uint16_t halfSpread(int64_t lo, int64_t hi)
+  {
+    int64_t d = (hi - lo) / 2;
+    return d > 65535 ? 65535 : uint16_t(d);
+  }
+
+}
+
+namespace crt {
+
+  void CRTTzeroClusters::clear()
+  {
+    tzeros.clear();
+    hit_begin.assign(1, 0);
+    hit_index.clear();
+  }
+
+  CRTTzeroClusterer::CRTTzeroClusterer(const CRTTzeroClustererConfig& cfg)
+    : fConfig(cfg)
+  {}
+
+  int64_t CRTTzeroClusterer::hitTime(const CRTHit& hit) const
+  {
+    if (fConfig.useTs1) return hit.ts1_ns;
+    return correctedTime(hit);
+  }
+
+  CRTTzeroClusters CRTTzeroClusterer::cluster(const std::vector<CRTHit>& hits) const
+  {
+    CRTTzeroClusters out;
+    cluster(hits, out);
+    return out;
+  }
+
+  void CRTTzeroClusterer::cluster(const std::vector<CRTHit>& hits, CRTTzeroClusters& out) const
+  {
+    out.clear();
+
+    std::vector<std::pair<int64_t, size_t> > keyed;
+    keyed.reserve(hits.size());
+    for (size_t i = 0; i < hits.size(); ++i) {
+      if (hits[i].peshit >= fConfig.minPE) keyed.emplace_back(hitTime(hits[i]), i);
+    }
+    if (!std::is_sorted(keyed.begin(), keyed.end())) std::sort(keyed.begin(), keyed.end());
+    out.hit_index.reserve(keyed.size());
+
+    size_t first = 0;
+    while (first < keyed.size()) {
+      const int64_t start = keyed[first].first;
+      size_t last = first;
+      while (last < keyed.size() && keyed[last].first - start <= fConfig.window_ns) ++last;
+
+      CRTTzero tz;
+      std::fill(tz.nhits, tz.nhits + 4, 0);
+      std::fill(tz.pes, tz.pes + 4, 0.);
+      // times relative to the first hit, so the sums cannot overflow
+      // (keyed already holds the corrected times unless clustering on ts1)
+      const int64_t ref0 = fConfig.useTs1 ? correctedTime(hits[keyed[first].second]) : keyed[first].first;
+      int64_t sum0 = 0, lo0 = INT64_MAX, hi0 = INT64_MIN;
+      int64_t sum1 = 0, lo1 = INT64_MAX, hi1 = INT64_MIN;
+      for (size_t k = first; k < last; ++k) {
+        const CRTHit& h = hits[keyed[k].second];
+        if (h.plane >= 0 && h.plane < 4) {
+          ++tz.nhits[h.plane];
+          tz.pes[h.plane] += h.peshit;
+        }
+        const int64_t t0 = (fConfig.useTs1 ? correctedTime(h) : keyed[k].first) - ref0, t1 = h.ts1_ns;
+        sum0 += t0; lo0 = std::min(lo0, t0); hi0 = std::max(hi0, t0);
+        sum1 += t1; lo1 = std::min(lo1, t1); hi1 = std::max(hi1, t1);
+        out.hit_index.push_back(keyed[k].second);
+      }
+
+      const int64_t n = int64_t(last - first);
+      const int64_t mean0 = ref0 + sum0 / n;
+      tz.ts0_s = uint32_t(secondsOf(mean0));
+      tz.ts0_s_err = 0;
+      tz.ts0_ns = uint32_t(nanosecondsOf(mean0));
+      tz.ts0_ns_err = halfSpread(lo0, hi0);
+      tz.ts1_ns = int32_t(sum1 / n);
+      tz.ts1_ns_err = halfSpread(lo1, hi1);
+
+      out.tzeros.push_back(tz);
+      out.hit_begin.push_back(out.hit_index.size());
+      first = last;
+    }
+  }
+
+}
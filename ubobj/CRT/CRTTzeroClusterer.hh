@@ -0,0 +1,64 @@
+/**
+ * \class CRTTzeroClusterer
+ *
+ * \ingroup crt
+ *
+ * \brief Groups time-ordered CRTHits into CRTTzeros
+ *
+ * One linear pass over the hits in time order: a cluster opens at a hit and
+ * takes every following hit within window_ns of that first hit. Each
+ * cluster becomes a CRTTzero with nhits[plane]/pes[plane] filled for planes
+ * 0-3, the mean time of its hits in ts0_s/ts0_ns/ts1_ns and half the time
+ * spread in the _err fields.
+ *
+ * The CRTTzero-CRTHit association comes out in bulk as offsets into one
+ * index array (hits of tzero k: hit_index[hit_begin[k] .. hit_begin[k+1])),
+ * so a producer can reserve once and fill its art::Assns in a single loop.
+ *
+ */
+
+
+#ifndef CRTTzeroClusterer_hh_
+#define CRTTzeroClusterer_hh_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ubobj/CRT/CRTHit.hh"
+#include "ubobj/CRT/CRTTzero.hh"
+
+namespace crt {
+
+  struct CRTTzeroClustererConfig{
+    int64_t window_ns = 100; // maximum time from the first hit of a cluster
+    bool useTs1 = false; // cluster on ts1_ns instead of the corrected ts0 time (CRTTime.hh)
+    float minPE = 0; // ignore hits with peshit below this
+  };
+
+  struct CRTTzeroClusters{
+    std::vector<CRTTzero> tzeros;
+    std::vector<size_t> hit_begin; // tzeros.size()+1 offsets into hit_index
+    std::vector<size_t> hit_index; // indices into the input hit collection
+
+    void clear();
+  };
+
+  class CRTTzeroClusterer{
+    public:
+    explicit CRTTzeroClusterer(const CRTTzeroClustererConfig& cfg=CRTTzeroClustererConfig());
+
+    // hits in any order (already sorted input skips the sort)
+    CRTTzeroClusters cluster(const std::vector<CRTHit>& hits) const;
+    void cluster(const std::vector<CRTHit>& hits, CRTTzeroClusters& out) const; // reuses out's storage
+
+    int64_t hitTime(const CRTHit& hit) const;
+    const CRTTzeroClustererConfig& config() const { return fConfig; }
+
+    private:
+    CRTTzeroClustererConfig fConfig;
+
+  };
+
+}
+
+#endif
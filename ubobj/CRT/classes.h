@@ -11,6 +11,7 @@
 #include "canvas/Persistency/Common/Wrapper.h"
 #include "ubobj/CRT/CRTSimData.hh"
 #include "ubobj/CRT/CRTHit.hh"
+#include "ubobj/CRT/CRTHitCollection.hh"
 #include "ubobj/CRT/CRTTrack.hh"
 #include "ubobj/CRT/CRTTzero.hh"
 #include "lardataobj/RecoBase/Track.h"
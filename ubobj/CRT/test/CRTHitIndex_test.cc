@@ -0,0 +1,115 @@
+/**
+ * \file CRTHitIndex_test.cc
+ *
+ * \brief Unit test of crt::CRTHitIndex: time windows per plane and across
+ * planes, the plane wildcard, radius queries against a brute-force scan, and
+ * independence from the indexed collection
+ *
+ */
+
+#define BOOST_TEST_MODULE ( CRTHitIndex_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/CRT/CRTHitIndex.hh"
+#include "ubobj/CRT/CRTSimDigitizer.hh"
+#include "ubobj/CRT/CRTTime.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+  crt::CRTHit makeHit(int plane, uint32_t ns, float x, float y, float z, int32_t ns_corr = 0)
+  {
+    crt::CRTHit hit;
+    hit.peshit = 10;
+    hit.ts0_s = 7;
+    hit.ts0_s_corr = 0;
+    hit.ts0_ns = ns;
+    hit.ts0_ns_corr = ns_corr;
+    hit.ts1_ns = int32_t(ns) / 10;
+    hit.plane = plane;
+    hit.x_pos = x; hit.y_pos = y; hit.z_pos = z;
+    hit.x_err = hit.y_err = hit.z_err = 1;
+    return hit;
+  }
+
+  typedef std::vector<size_t> Indices;
+
+}
+
+BOOST_AUTO_TEST_CASE(time_windows)
+{
+  std::vector<crt::CRTHit> hits{ makeHit(0, 1000, 0, 0, 0), makeHit(1, 1000, 0, 0, 0), makeHit(0, 1100, 0, 0, 0),
+                                 makeHit(0, 1300, 0, 0, 0, -250), makeHit(1, 900, 0, 0, 0), makeHit(3, 5000, 0, 0, 0) };
+  crt::CRTHitIndex index(hits);
+  const int64_t t = crt::absoluteTime(7, 1000);
+
+  BOOST_TEST(index.size() == hits.size());
+  BOOST_TEST(index.hitTime(3) == crt::absoluteTime(7, 1050));
+  BOOST_CHECK(index.planes() == (std::vector<int>{ 0, 1, 3 }));
+
+  // window edges are inclusive; the corrected time is what counts
+  BOOST_CHECK(index.inTimeWindow(0, t, 100) == (Indices{ 0, 3, 2 }));
+  BOOST_CHECK(index.inTimeWindow(0, t, 49) == (Indices{ 0 }));
+  BOOST_CHECK(index.inTimeWindow(2, t, 100).empty());
+  // across planes: time order, equal times by index
+  BOOST_CHECK(index.inTimeWindow(crt::CRTHitIndex::kAnyPlane, t, 100) == (Indices{ 4, 0, 1, 3, 2 }));
+
+  crt::CRTHitIndex byTs1(hits, 50., crt::CRTHitIndex::kTs1);
+  BOOST_CHECK(byTs1.inTimeWindow(0, 100, 10) == (Indices{ 0, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(unknown_plane_is_not_the_wildcard)
+{
+  // digitizer candidates carry plane -1 until the geometry is applied
+  std::vector<crt::CRTHit> hits{ makeHit(crt::CRTSimDigitizer::kUnknownPlane, 1000, 0, 0, 0), makeHit(2, 1000, 0, 0, 0) };
+  crt::CRTHitIndex index(hits);
+  const int64_t t = crt::absoluteTime(7, 1000);
+
+  BOOST_CHECK(index.inTimeWindow(-1, t, 10) == (Indices{ 0 }));
+  BOOST_CHECK(index.query(-1, t, 10, 0, 0, 0, 1) == (Indices{ 0 }));
+  BOOST_CHECK(index.inTimeWindow(crt::CRTHitIndex::kAnyPlane, t, 10) == (Indices{ 0, 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(queries_match_brute_force)
+{
+  std::mt19937 rng(2024);
+  std::uniform_int_distribution<int> plane(0, 2);
+  std::uniform_int_distribution<uint32_t> ns(0, 20000);
+  std::uniform_real_distribution<float> pos(-400, 400);
+  std::vector<crt::CRTHit> hits;
+  for (int i = 0; i < 3000; ++i) hits.push_back(makeHit(plane(rng), ns(rng), pos(rng), pos(rng), pos(rng)));
+
+  for (float cell : { 10.f, 50.f, 1000.f }) {
+    crt::CRTHitIndex index(hits, cell);
+    for (int q = 0; q < 200; ++q) {
+      const int p = (q % 4 == 3) ? crt::CRTHitIndex::kAnyPlane : q % 4;
+      const int64_t t = crt::absoluteTime(7, ns(rng)), dt = 2000;
+      const float x = pos(rng), y = pos(rng), z = pos(rng), r = (q % 5) * 60.f;
+
+      Indices expected;
+      for (size_t i = 0; i < hits.size(); ++i) {
+        const crt::CRTHit& h = hits[i];
+        const int64_t d = crt::correctedTime(h) - t;
+        const float dx = h.x_pos - x, dy = h.y_pos - y, dz = h.z_pos - z;
+        if ((p == crt::CRTHitIndex::kAnyPlane || h.plane == p) && d >= -dt && d <= dt && dx * dx + dy * dy + dz * dz <= r * r)
+          expected.push_back(i);
+      }
+      BOOST_CHECK(index.query(p, t, dt, x, y, z, r) == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(index_outlives_hits)
+{
+  std::unique_ptr<crt::CRTHitIndex> index;
+  {
+    std::vector<crt::CRTHit> hits{ makeHit(0, 1000, 10, 0, 0), makeHit(0, 1010, 200, 0, 0) };
+    index.reset(new crt::CRTHitIndex(hits));
+  }
+  BOOST_CHECK(index->query(0, crt::absoluteTime(7, 1000), 50, 0, 0, 0, 20) == (Indices{ 0 }));
+}
@@ -0,0 +1,83 @@
+/**
+ * \file CRTSimDigitizer_test.cc
+ *
+ * \brief Unit test of crt::CRTSimDigitizer: the radix sort against
+ * std::stable_sort, channel sorting and hit candidates
+ *
+ */
+
+#define BOOST_TEST_MODULE ( CRTSimDigitizer_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/CRT/CRTSimDigitizer.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::vector<uint32_t> stableOrder(const std::vector<uint64_t>& keys)
+  {
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return order;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(radix_order_matches_stable_sort)
+{
+  BOOST_TEST(crt::CRTSimDigitizer::radixOrder({}).empty());
+
+  std::mt19937_64 rng(7);
+  // full-width keys, keys with empty digits (skipped passes), and many duplicates
+  for (uint64_t mask : { ~uint64_t(0), uint64_t(0xFFFF00000000FFFF), uint64_t(0xF000000000000003) }) {
+    for (size_t n : { 1u, 2u, 100u, 70000u }) {
+      std::vector<uint64_t> keys(n);
+      for (auto& k : keys) k = rng() & mask;
+      const std::vector<uint32_t> order = crt::CRTSimDigitizer::radixOrder(keys);
+      BOOST_TEST(order == stableOrder(keys), boost::test_tools::per_element());
+    }
+  }
+
+  std::vector<uint64_t> same(1000, 42);
+  BOOST_TEST(crt::CRTSimDigitizer::radixOrder(same) == stableOrder(same), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(sort_by_channel)
+{
+  std::vector<crt::CRTSimData> data{ { 5, 300, 3, 10, 1 }, { 2, 100, 1, 11, 2 }, { 5, 200, 2, 12, 3 }, { 2, 100, 9, 13, 4 } };
+  crt::CRTSimChannelData out;
+  crt::CRTSimDigitizer::sortByChannel(data, out);
+
+  BOOST_TEST(out.channel == (std::vector<uint32_t>{ 2, 5 }), boost::test_tools::per_element());
+  BOOST_TEST(out.begin == (std::vector<uint32_t>{ 0, 2, 4 }), boost::test_tools::per_element());
+  BOOST_TEST(out.t0 == (std::vector<uint32_t>{ 100, 100, 200, 300 }), boost::test_tools::per_element());
+  // equal (channel, T0) keep their input order
+  BOOST_TEST(out.source == (std::vector<uint32_t>{ 1, 3, 2, 0 }), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(hit_candidates)
+{
+  crt::CRTSimDigitizerConfig cfg;
+  cfg.channelsPerFEB = 32;
+  cfg.window_ns = 50;
+  crt::CRTSimDigitizer digitizer(cfg);
+
+  // FEB 0: two samples in coincidence and a late one; FEB 1: one sample
+  std::vector<crt::CRTSimData> data{ { 3, 1000, 40, 5, 1 }, { 33, 1010, 20, 7, 2 }, { 1, 1030, 30, 2, 3 }, { 4, 1200, 50, 1, 4 } };
+  std::vector<crt::CRTHit> hits = digitizer.makeHits(data);
+
+  BOOST_TEST_REQUIRE(hits.size() == 3u);
+  BOOST_TEST(hits[0].feb_id[0] == 0u);
+  BOOST_TEST(hits[0].ts0_ns == 1000u);
+  BOOST_TEST(hits[0].ts1_ns == 30);
+  BOOST_TEST(hits[0].peshit == 7.f);
+  BOOST_TEST(hits[0].plane == crt::CRTSimDigitizer::kUnknownPlane);
+  BOOST_TEST(hits[1].ts0_ns == 1200u);
+  BOOST_TEST(hits[2].feb_id[0] == 1u);
+}
@@ -0,0 +1,145 @@
+/**
+ * \file CRTTPCMatcher_test.cc
+ *
+ * \brief Unit test of the crt::CRTTPCMatcher kernels against plain scalar
+ * loops, over block sizes that exercise the vector body and every tail
+ * length, and of match() with and without candidate lists
+ *
+ * The kernels are compiled into the library with or without AVX2; this
+ * test checks whichever path the library was built with.
+ *
+ */
+
+#define BOOST_TEST_MODULE ( CRTTPCMatcher_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/CRT/CRTTPCMatcher.hh"
+#include "ubobj/CRT/CRTTime.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+  double referenceDCA(const crt::CRTTPCLine& line, double x, double y, double z)
+  {
+    const double norm = std::sqrt(double(line.dx) * line.dx + double(line.dy) * line.dy + double(line.dz) * line.dz);
+    const double ux = line.dx / norm, uy = line.dy / norm, uz = line.dz / norm;
+    const double vx = x - line.x, vy = y - line.y, vz = z - line.z;
+    const double cx = vy * uz - vz * uy, cy = vz * ux - vx * uz, cz = vx * uy - vy * ux;
+    return std::sqrt(cx * cx + cy * cy + cz * cz);
+  }
+
+  crt::CRTHit makeHit(uint32_t ns, float x, float y, float z)
+  {
+    crt::CRTHit hit;
+    hit.peshit = 10;
+    hit.ts0_s = 3;
+    hit.ts0_s_corr = 0;
+    hit.ts0_ns = ns;
+    hit.ts0_ns_corr = 0;
+    hit.ts1_ns = 0;
+    hit.plane = 0;
+    hit.x_pos = x; hit.y_pos = y; hit.z_pos = z;
+    hit.x_err = hit.y_err = hit.z_err = 1;
+    return hit;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(dca_exact_on_axis_lines)
+{
+  // line along x: the distance is exactly sqrt(y^2 + z^2) in float too
+  const crt::CRTTPCLine line{ 0, 0, 0, 2, 0, 0, 0 };
+  for (size_t n = 0; n <= 19; ++n) {
+    std::vector<float> x(n), y(n), z(n), dca(n, -1);
+    for (size_t i = 0; i < n; ++i) { x[i] = float(i) - 7; y[i] = 3; z[i] = (i % 2) ? 4 : -4; }
+    crt::dcaToLine(line, x.data(), y.data(), z.data(), n, dca.data());
+    for (size_t i = 0; i < n; ++i) BOOST_TEST(dca[i] == 5.f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dca_matches_reference)
+{
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<float> pos(-100, 100);
+  for (size_t n = 0; n <= 35; ++n) {
+    const crt::CRTTPCLine line{ pos(rng), pos(rng), pos(rng), pos(rng), pos(rng), pos(rng), 0 };
+    std::vector<float> x(n), y(n), z(n), dca(n);
+    for (size_t i = 0; i < n; ++i) { x[i] = pos(rng); y[i] = pos(rng); z[i] = pos(rng); }
+    crt::dcaToLine(line, x.data(), y.data(), z.data(), n, dca.data());
+    for (size_t i = 0; i < n; ++i) {
+      // r^2 - proj^2 in float loses about sqrt(eps) * r near the line
+      const double vx = x[i] - line.x, vy = y[i] - line.y, vz = z[i] - line.z;
+      const double tol = 1e-3 * std::sqrt(vx * vx + vy * vy + vz * vz) + 1e-4;
+      BOOST_TEST(std::abs(dca[i] - referenceDCA(line, x[i], y[i], z[i])) <= tol);
+    }
+  }
+
+  // a degenerate line is a point
+  const crt::CRTTPCLine point{ 1, 2, 3, 0, 0, 0, 0 };
+  float px = 4, py = 6, pz = 3, d = 0;
+  crt::dcaToLine(point, &px, &py, &pz, 1, &d);
+  BOOST_TEST(d == 5.f);
+}
+
+BOOST_AUTO_TEST_CASE(time_window_matches_reference)
+{
+  const int64_t kMax = std::numeric_limits<int64_t>::max(), kMin = std::numeric_limits<int64_t>::min();
+  const int64_t window = 100;
+  for (int64_t t : { int64_t(0), int64_t(5000), kMax - 50, kMin + 50 }) {
+    // edges of the window, just outside them, and values that wrap around t
+    auto at = [t](int64_t d) { return int64_t(uint64_t(t) + uint64_t(d)); }; // t + d, wrapping
+    std::vector<int64_t> values{ t, at(window), at(-window), at(window + 1), at(-window - 1), at(kMax), at(kMin), kMax, kMin, 0 };
+    for (size_t n = 0; n <= 19; ++n) {
+      std::vector<int64_t> times(n);
+      for (size_t i = 0; i < n; ++i) times[i] = values[(i * 7) % values.size()];
+      std::vector<uint8_t> pass(n, 2);
+      crt::inTimeWindow(t, window, times.data(), n, pass.data());
+      for (size_t i = 0; i < n; ++i) {
+        const int64_t d = int64_t(uint64_t(times[i]) - uint64_t(t));
+        BOOST_TEST(pass[i] == uint8_t(d <= window && d >= -window));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(candidates_select_the_same_matches)
+{
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> pos(-300, 300);
+  std::uniform_int_distribution<uint32_t> ns(0, 4000);
+  std::vector<crt::CRTHit> hits;
+  for (int i = 0; i < 203; ++i) hits.push_back(makeHit(ns(rng), pos(rng), pos(rng), pos(rng)));
+  const crt::CRTHitCollection block(hits);
+  std::vector<int64_t> times;
+  crt::correctedTimes(block, times);
+
+  crt::CRTTPCMatcherConfig cfg;
+  cfg.maxDCA = 120;
+  cfg.timeWindow_ns = 1500;
+  cfg.nSigma = 2;
+  crt::CRTTPCMatcher matcher(cfg);
+  const crt::CRTTPCLine line{ 0, 0, 0, 1, 1, 0, crt::absoluteTime(3, 2000) };
+
+  std::vector<crt::CRTTPCMatch> all;
+  matcher.match(4, line, block, times, nullptr, all);
+  BOOST_TEST_REQUIRE(!all.empty());
+
+  std::vector<size_t> odd;
+  for (size_t i = 1; i < hits.size(); i += 2) odd.push_back(i);
+  std::vector<crt::CRTTPCMatch> some;
+  matcher.match(4, line, block, times, &odd, some);
+
+  std::vector<crt::CRTTPCMatch> expected;
+  for (auto const& m : all) if (m.crt % 2) expected.push_back(m);
+  BOOST_TEST_REQUIRE(some.size() == expected.size());
+  for (size_t k = 0; k < some.size(); ++k) {
+    BOOST_TEST(some[k].track == 4u);
+    BOOST_TEST(some[k].crt == expected[k].crt);
+    BOOST_TEST(some[k].dca == expected[k].dca);
+  }
+}
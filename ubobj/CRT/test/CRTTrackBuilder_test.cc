@@ -0,0 +1,171 @@
+/**
+ * \file CRTTrackBuilder_test.cc
+ *
+ * \brief Unit test of crt::CRTTrackBuilder: coincidence window, second
+ * boundaries and agreement of the sliced (multithreaded) and serial builds
+ *
+ */
+
+#define BOOST_TEST_MODULE ( CRTTrackBuilder_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/CRT/CRTTime.hh"
+#include "ubobj/CRT/CRTTrackBuilder.hh"
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  crt::CRTHit makeHit(int plane, uint32_t s, uint32_t ns, int32_t ns_corr = 0)
+  {
+    crt::CRTHit hit;
+    hit.feb_id.push_back(uint8_t(plane));
+    hit.peshit = 10;
+    hit.ts0_s = s;
+    hit.ts0_s_corr = 0;
+    hit.ts0_ns = ns;
+    hit.ts0_ns_corr = ns_corr;
+    hit.ts1_ns = int32_t(ns);
+    hit.plane = plane;
+    hit.x_pos = hit.y_pos = hit.z_pos = 0;
+    hit.x_err = hit.y_err = hit.z_err = 1;
+    return hit;
+  }
+
+  typedef std::vector<std::pair<size_t, size_t> > Pairs;
+
+}
+
+BOOST_AUTO_TEST_CASE(pairs_within_window)
+{
+  // planes 0/1 in coincidence, plane 2 alone, and a same-plane pair that must not match
+  std::vector<crt::CRTHit> hits{ makeHit(1, 5, 1050), makeHit(2, 5, 1400), makeHit(0, 5, 1000), makeHit(0, 5, 1020) };
+  crt::CRTTrackBuilder builder;
+  Pairs pairs;
+  std::vector<crt::CRTTrack> tracks = builder.build(hits, &pairs);
+
+  BOOST_CHECK(pairs == (Pairs{ {2, 0}, {3, 0} }));
+  BOOST_TEST_REQUIRE(tracks.size() == 2u);
+  BOOST_TEST(tracks[0].plane1 == 0);
+  BOOST_TEST(tracks[0].plane2 == 1);
+  BOOST_TEST(tracks[0].ts0_s == 5u);
+  BOOST_TEST(tracks[0].ts0_ns == 1025u);
+  BOOST_TEST(tracks[0].ts0_ns_err == 25u);
+}
+
+BOOST_AUTO_TEST_CASE(window_boundary)
+{
+  crt::CRTTrackBuilderConfig cfg;
+  cfg.window_ns = 100;
+  crt::CRTTrackBuilder builder(cfg);
+
+  // exactly window_ns apart pairs, one more nanosecond does not
+  std::vector<crt::CRTHit> edge{ makeHit(0, 5, 1000), makeHit(1, 5, 1100) };
+  BOOST_TEST(builder.build(edge).size() == 1u);
+  std::vector<crt::CRTHit> outside{ makeHit(0, 5, 1000), makeHit(1, 5, 1101) };
+  BOOST_TEST(builder.build(outside).empty());
+
+  // the window applies to the corrected time, not the raw ts0_ns
+  std::vector<crt::CRTHit> corrected{ makeHit(0, 5, 1000), makeHit(1, 5, 1300, -200) };
+  BOOST_TEST(builder.build(corrected).size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(pair_across_second_boundary)
+{
+  std::vector<crt::CRTHit> hits{ makeHit(0, 10, 999999990), makeHit(1, 11, 30) };
+  crt::CRTTrackBuilder builder;
+  std::vector<crt::CRTTrack> tracks = builder.build(hits);
+
+  BOOST_TEST_REQUIRE(tracks.size() == 1u);
+  const crt::CRTTrack& tr = tracks[0];
+  BOOST_TEST(tr.ts0_s == 11u);
+  BOOST_TEST(tr.ts0_ns == 10u);
+  BOOST_TEST(tr.ts0_s_err == 0u);
+  BOOST_TEST(tr.ts0_ns_err == 20u);
+  BOOST_TEST(crt::absoluteTime(tr) == crt::absoluteTime(11, 10));
+}
+
+BOOST_AUTO_TEST_CASE(slices_match_serial_build)
+{
+  // dense random hits over a few seconds, so many pairs share hits and cross slice edges
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> plane(0, 3);
+  std::uniform_int_distribution<uint32_t> second(100, 102), ns(0, 999999999);
+  std::uniform_int_distribution<int32_t> corr(-50, 50);
+  std::vector<crt::CRTHit> hits;
+  for (int i = 0; i < 4000; ++i) hits.push_back(makeHit(plane(rng), second(rng), ns(rng) % 2000000 + (i % 2 ? 998000000 : 0), corr(rng)));
+
+  crt::CRTTrackBuilderConfig cfg;
+  cfg.window_ns = 2000;
+  crt::CRTTrackBuilder builder(cfg);
+  Pairs serialPairs;
+  std::vector<crt::CRTTrack> serial = builder.build(hits, &serialPairs);
+  BOOST_TEST_REQUIRE(serialPairs.size() > 100u);
+
+  const std::vector<size_t> order = builder.timeOrder(hits);
+  for (size_t nSlices : { 1u, 2u, 3u, 7u, 16u }) {
+    auto ranges = crt::CRTTrackBuilder::slices(order.size(), nSlices);
+    std::vector<std::vector<crt::CRTTrack> > sliceTracks(ranges.size());
+    std::vector<Pairs> slicePairs(ranges.size());
+    std::vector<std::thread> workers;
+    for (size_t s = 0; s < ranges.size(); ++s) {
+      workers.emplace_back([&, s] {
+        sliceTracks[s] = builder.buildSlice(hits, order, ranges[s].first, ranges[s].second, &slicePairs[s]);
+      });
+    }
+    for (auto& w : workers) w.join();
+
+    Pairs pairs;
+    std::vector<crt::CRTTrack> tracks;
+    for (size_t s = 0; s < ranges.size(); ++s) {
+      pairs.insert(pairs.end(), slicePairs[s].begin(), slicePairs[s].end());
+      tracks.insert(tracks.end(), sliceTracks[s].begin(), sliceTracks[s].end());
+    }
+    BOOST_CHECK(pairs == serialPairs);
+    BOOST_TEST_REQUIRE(tracks.size() == serial.size());
+    for (size_t k = 0; k < tracks.size(); ++k) {
+      BOOST_TEST(tracks[k].ts0_s == serial[k].ts0_s);
+      BOOST_TEST(tracks[k].ts0_ns == serial[k].ts0_ns);
+      BOOST_TEST(tracks[k].plane1 == serial[k].plane1);
+      BOOST_TEST(tracks[k].plane2 == serial[k].plane2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(hit_times_are_corrected)
+{
+  // hit 2's correction moves it back across the second boundary
+  std::vector<crt::CRTHit> hits{ makeHit(0, 10, 999999950), makeHit(1, 11, 100, -120) };
+  crt::CRTTrackBuilder builder;
+  std::vector<crt::CRTTrack> tracks = builder.build(hits);
+
+  BOOST_TEST_REQUIRE(tracks.size() == 1u);
+  BOOST_TEST(tracks[0].ts0_ns_h1 == 999999950u);
+  BOOST_TEST(tracks[0].ts0_ns_h2 == 999999980u);
+  BOOST_TEST(tracks[0].ts0_s == 10u);
+  BOOST_TEST(tracks[0].ts0_ns == 999999965u);
+}
+
+BOOST_AUTO_TEST_CASE(negative_times_split_into_s_and_ns)
+{
+  BOOST_TEST(crt::nanosecondsOf(-1) == 999999999);
+  BOOST_TEST(crt::secondsOf(-1) == -1);
+  BOOST_TEST(crt::nanosecondsOf(-crt::kNsPerSecond) == 0);
+  BOOST_TEST(crt::secondsOf(-crt::kNsPerSecond) == -1);
+  BOOST_TEST(crt::secondsOf(3 * crt::kNsPerSecond + 7) == 3);
+
+  // corrections that push both hits before t = 0
+  std::vector<crt::CRTHit> hits{ makeHit(0, 0, 100, -300), makeHit(1, 0, 100, -250) };
+  crt::CRTTrackBuilder builder;
+  std::vector<crt::CRTTrack> tracks = builder.build(hits);
+
+  BOOST_TEST_REQUIRE(tracks.size() == 1u);
+  BOOST_TEST(tracks[0].ts0_ns == 999999825u);
+  BOOST_TEST(int32_t(tracks[0].ts0_s) == -1);
+  BOOST_TEST(tracks[0].ts0_ns_h1 == 999999800u);
+  BOOST_TEST(tracks[0].ts0_ns_h2 == 999999850u);
+}
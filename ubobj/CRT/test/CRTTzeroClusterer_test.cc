@@ -0,0 +1,104 @@
+/**
+ * \file CRTTzeroClusterer_test.cc
+ *
+ * \brief Unit test of crt::CRTTzeroClusterer: cluster boundaries, per-plane
+ * sums, mean times and spreads, the hit association and storage reuse
+ *
+ */
+
+#define BOOST_TEST_MODULE ( CRTTzeroClusterer_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/CRT/CRTTime.hh"
+#include "ubobj/CRT/CRTTzeroClusterer.hh"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+  crt::CRTHit makeHit(int plane, uint32_t s, uint32_t ns, float pe = 10, int32_t ns_corr = 0)
+  {
+    crt::CRTHit hit;
+    hit.peshit = pe;
+    hit.ts0_s = s;
+    hit.ts0_s_corr = 0;
+    hit.ts0_ns = ns;
+    hit.ts0_ns_corr = ns_corr;
+    hit.ts1_ns = int32_t(ns % 1000);
+    hit.plane = plane;
+    hit.x_pos = hit.y_pos = hit.z_pos = 0;
+    hit.x_err = hit.y_err = hit.z_err = 1;
+    return hit;
+  }
+
+  std::vector<size_t> hitsOf(const crt::CRTTzeroClusters& c, size_t k)
+  {
+    return std::vector<size_t>(c.hit_index.begin() + c.hit_begin[k], c.hit_index.begin() + c.hit_begin[k + 1]);
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(clusters_and_sums)
+{
+  // out of order on purpose; the window runs from each cluster's first hit
+  std::vector<crt::CRTHit> hits{ makeHit(1, 5, 1050, 20), makeHit(0, 5, 1000, 10), makeHit(1, 5, 1100, 5),
+                                 makeHit(3, 5, 1101, 7), makeHit(7, 5, 1150, 1) };
+  crt::CRTTzeroClusterer clusterer;
+  crt::CRTTzeroClusters c = clusterer.cluster(hits);
+
+  BOOST_TEST_REQUIRE(c.tzeros.size() == 2u);
+  BOOST_TEST_REQUIRE(c.hit_begin.size() == 3u);
+  BOOST_CHECK(hitsOf(c, 0) == (std::vector<size_t>{ 1, 0, 2 }));
+  BOOST_CHECK(hitsOf(c, 1) == (std::vector<size_t>{ 3, 4 }));
+
+  const crt::CRTTzero& tz = c.tzeros[0];
+  BOOST_TEST(tz.nhits[0] == 1);
+  BOOST_TEST(tz.nhits[1] == 2);
+  BOOST_TEST(tz.nhits[3] == 0);
+  BOOST_TEST(tz.pes[1] == 25.);
+  BOOST_TEST(tz.ts0_s == 5u);
+  BOOST_TEST(tz.ts0_ns == 1050u);
+  BOOST_TEST(tz.ts0_ns_err == 50u);
+  BOOST_TEST(tz.ts1_ns == 50);
+
+  // plane 7 is outside 0-3: in the association, not in the per-plane sums
+  BOOST_TEST(c.tzeros[1].nhits[3] == 1);
+  BOOST_TEST(c.tzeros[1].pes[3] == 7.);
+}
+
+BOOST_AUTO_TEST_CASE(corrected_time_and_second_boundary)
+{
+  // the correction moves the second hit into the first one's window, across the second
+  std::vector<crt::CRTHit> hits{ makeHit(0, 10, 999999980), makeHit(1, 11, 500, 10, -480), makeHit(2, 11, 500) };
+  crt::CRTTzeroClusterer clusterer;
+  crt::CRTTzeroClusters c = clusterer.cluster(hits);
+
+  BOOST_TEST_REQUIRE(c.tzeros.size() == 2u);
+  BOOST_CHECK(hitsOf(c, 0) == (std::vector<size_t>{ 0, 1 }));
+  BOOST_TEST(c.tzeros[0].ts0_s == 11u);
+  BOOST_TEST(c.tzeros[0].ts0_ns == 0u);
+  BOOST_TEST(crt::absoluteTime(c.tzeros[0]) == crt::absoluteTime(11, 0));
+  BOOST_TEST(c.tzeros[0].ts0_ns_err == 20u);
+}
+
+BOOST_AUTO_TEST_CASE(config_and_reuse)
+{
+  std::vector<crt::CRTHit> hits{ makeHit(0, 5, 1000, 1), makeHit(1, 5, 1030, 10), makeHit(2, 5, 2000, 10) };
+
+  crt::CRTTzeroClustererConfig cfg;
+  cfg.minPE = 5;
+  cfg.window_ns = 10;
+  crt::CRTTzeroClusterer clusterer(cfg);
+
+  crt::CRTTzeroClusters c;
+  clusterer.cluster(hits, c);
+  BOOST_TEST(c.tzeros.size() == 2u);
+  BOOST_CHECK(c.hit_index == (std::vector<size_t>{ 1, 2 }));
+
+  // filling again replaces the previous result
+  clusterer.cluster(std::vector<crt::CRTHit>{}, c);
+  BOOST_TEST(c.tzeros.empty());
+  BOOST_CHECK(c.hit_begin == (std::vector<size_t>{ 0 }));
+  BOOST_TEST(c.hit_index.empty());
+}
@@ -1,6 +1,7 @@
 #include "Flash.hh"
 #include <iostream>
 #include <algorithm>
+#include <utility>
 
 #ifdef __BUILD_ROOT_DICT__
 ClassImp( subevent::Flash )
@@ -35,28 +36,34 @@ namespace subevent {
     storeExpectation( orig.expectation );
   }
 
+  Flash::Flash( Flash&& orig ) noexcept :
+#ifdef __BUILD_ROOT_DICT__
+    TObject( orig ),
+#endif
+    ch( orig.ch ), tstart( orig.tstart ), tend( orig.tend ), tmax( orig.tmax ), maxamp( orig.maxamp ),
+    area( orig.area ), area30( orig.area30 ), fcomp_gausintegral( orig.fcomp_gausintegral), claimed( orig.claimed ),
+    expectation( std::move( orig.expectation ) ), waveform( std::move( orig.waveform ) )
+  {}
+
   Flash::~Flash() {
     expectation.clear();
     waveform.clear();
   }
 
   void Flash::storeWaveform( const std::vector< double >& waveform_ ) {
-    waveform.clear();
-    waveform.reserve( waveform_.size() );
+    waveform.assign( waveform_.begin(), waveform_.end() );
+  }
 
-    for ( std::vector< double >::const_iterator it=waveform_.begin(); it!=waveform_.end(); it++ ) {
-      waveform.push_back( (double)*it );
-    }
+  void Flash::storeWaveform( const std::vector< float >& waveform_ ) {
+    waveform = waveform_;
   }
 
   void Flash::storeExpectation( const std::vector< double >& expectation_ ) {
-    expectation.clear();
-    expectation.reserve( expectation_.size() );    
-    for ( std::vector< double >::const_iterator it=expectation_.begin(); it!=expectation_.end(); it++ ) {
-      //std::cout << *it << " ";
-      expectation.push_back( *it );
-    }    
-    //std::cout << std::endl;
+    expectation.assign( expectation_.begin(), expectation_.end() );
+  }
+
+  void Flash::storeExpectation( const std::vector< float >& expectation_ ) {
+    expectation = expectation_;
   }
   
 }
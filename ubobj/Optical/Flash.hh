@@ -18,24 +18,35 @@ namespace subevent {
     Flash();
     Flash( int ch, int tstart, int tend, int tmax, float maxamp, std::vector< double >& expectation, std::vector< double >& waveform );
     Flash( const Flash& orig ); // copy constructor
+#ifndef __CINT__ // hide from rootcint
+#ifndef __GCCXML__
+    Flash( Flash&& orig ) noexcept; // takes over the waveform and expectation buffers
+    Flash& operator=( const Flash& orig ) = default;
+    Flash& operator=( Flash&& orig ) = default;
+#endif
+#endif
     ~Flash();
     
     void storeWaveform( const std::vector< double >& waveform );
+    void storeWaveform( const std::vector< float >& waveform );
     void storeExpectation( const std::vector< double >& expectation );
+    void storeExpectation( const std::vector< float >& expectation );
 
     int ch;
     int tstart;
     int tend;
     int tmax;
-    double maxamp;
-    double area;
-    double area30;
-    double fcomp_gausintegral;
+    // stored as float32: the physical precision is far below double.
+    // files written with the double layout are converted by the read rules in classes_def.xml
+    float maxamp;
+    float area;
+    float area30;
+    float fcomp_gausintegral;
     bool claimed;
-    std::vector< double > expectation;
-    std::vector< double > waveform;
+    std::vector< float > expectation;
+    std::vector< float > waveform;
 #ifdef __BUILD_ROOT_DICT__
-    ClassDef( Flash, 1 );
+    ClassDef( Flash, 2 );
 #endif
   };
 
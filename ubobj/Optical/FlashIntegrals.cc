@@ -0,0 +1,114 @@
+#include "FlashIntegrals.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace subevent {
+
+  namespace {
+
+  template< typename T >
+  double sampleSumT( const T* samples, std::size_t n ) {
+    // four independent partial sums break the add dependency chain
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    std::size_t i = 0;
+    for ( ; i+4<=n; i+=4 ) {
+      s0 += samples[i];
+      s1 += samples[i+1];
+      s2 += samples[i+2];
+      s3 += samples[i+3];
+    }
+    for ( ; i<n; i++ )
+      s0 += samples[i];
+    return (s0+s1)+(s2+s3);
+  }
+
+  template< typename T >
+  double windowSumT( const T* samples, std::size_t n, std::size_t first, std::size_t len ) {
+    if ( first>=n ) return 0.0;
+    return sampleSumT( samples+first, std::min( len, n-first ) );
+  }
+
+  template< typename T >
+  FlashPeak findPeakT( const T* samples, std::size_t n ) {
+    FlashPeak peak = { -1, 0.0 };
+    if ( n==0 ) return peak;
+    // branch-free max first, then locate its first occurrence
+    T amp = samples[0];
+    for ( std::size_t i=1; i<n; i++ )
+      amp = std::max( amp, samples[i] );
+    peak.amp = amp;
+    peak.index = std::find( samples, samples+n, amp ) - samples;
+    return peak;
+  }
+
+  template< typename T >
+  double gaussianIntegralT( const T* samples, std::size_t n, double amp ) {
+    // width from the second moment of the positive part of the pulse,
+    // then the closed form A*sigma*sqrt(2pi)
+    double w = 0.0, wt = 0.0, wtt = 0.0;
+    for ( std::size_t i=0; i<n; i++ ) {
+      double q = std::max( (double)samples[i], 0.0 );
+      double t = (double)i;
+      w   += q;
+      wt  += q*t;
+      wtt += q*t*t;
+    }
+    if ( w<=0.0 ) return 0.0;
+    double mean = wt/w;
+    double var = wtt/w - mean*mean;
+    if ( var<=0.0 ) return 0.0;
+    return amp*std::sqrt( 2.0*M_PI*var );
+  }
+
+  }
+
+  double sampleSum( const float* samples, std::size_t n ) { return sampleSumT( samples, n ); }
+  double sampleSum( const double* samples, std::size_t n ) { return sampleSumT( samples, n ); }
+  double windowSum( const float* samples, std::size_t n, std::size_t first, std::size_t len ) { return windowSumT( samples, n, first, len ); }
+  double windowSum( const double* samples, std::size_t n, std::size_t first, std::size_t len ) { return windowSumT( samples, n, first, len ); }
+  FlashPeak findPeak( const float* samples, std::size_t n ) { return findPeakT( samples, n ); }
+  FlashPeak findPeak( const double* samples, std::size_t n ) { return findPeakT( samples, n ); }
+  double gaussianIntegral( const float* samples, std::size_t n, double amp ) { return gaussianIntegralT( samples, n, amp ); }
+  double gaussianIntegral( const double* samples, std::size_t n, double amp ) { return gaussianIntegralT( samples, n, amp ); }
+
+  double flashArea( const Flash& flash ) {
+    return sampleSum( flash.waveform.data(), flash.waveform.size() );
+  }
+
+  double flashArea30( const Flash& flash ) {
+    return windowSum( flash.waveform.data(), flash.waveform.size(), 0, kArea30Window );
+  }
+
+  FlashPeak flashPeak( const Flash& flash ) {
+    return findPeak( flash.waveform.data(), flash.waveform.size() );
+  }
+
+  double flashGausIntegral( const Flash& flash ) {
+    FlashPeak peak = flashPeak( flash );
+    return gaussianIntegral( flash.waveform.data(), flash.waveform.size(), peak.amp );
+  }
+
+  void fillIntegrals( Flash& flash ) {
+    const float* wf = flash.waveform.data();
+    std::size_t n = flash.waveform.size();
+    flash.area = sampleSum( wf, n );
+    flash.area30 = windowSum( wf, n, 0, kArea30Window );
+    FlashPeak peak = findPeak( wf, n );
+    if ( peak.index>=0 ) {
+      flash.tmax = flash.tstart + peak.index;
+      flash.maxamp = peak.amp;
+    }
+    flash.fcomp_gausintegral = gaussianIntegral( wf, n, peak.amp );
+  }
+
+  void fillIntegrals( FlashList& flashes ) {
+    for ( FlashListIter it=flashes.begin(); it!=flashes.end(); it++ )
+      fillIntegrals( *it );
+  }
+
+  void fillIntegrals( std::vector< Flash >& flashes ) {
+    for ( auto& flash : flashes )
+      fillIntegrals( flash );
+  }
+
+}
@@ -0,0 +1,49 @@
+#ifndef __FLASHINTEGRALS_HH__
+#define __FLASHINTEGRALS_HH__
+
+#include "Flash.hh"
+#include "FlashList.hh"
+#include <cstddef>
+#include <vector>
+
+// Integral kernels for subevent::Flash.
+// A flash's waveform is taken to hold the samples from tstart onward,
+// i.e. waveform[0] is tick tstart and waveform[tmax-tstart] is the peak.
+// The kernels run over contiguous float or double buffers with independent partial
+// sums so the compiler can vectorize them; they do not allocate.
+
+namespace subevent {
+
+  struct FlashPeak {
+    int index;     // sample index of the maximum within the buffer
+    double amp;    // value at that sample
+  };
+
+  // raw-buffer kernels; sums are accumulated in double for either input type
+  double sampleSum( const float* samples, std::size_t n );
+  double sampleSum( const double* samples, std::size_t n );
+  double windowSum( const float* samples, std::size_t n, std::size_t first, std::size_t len );
+  double windowSum( const double* samples, std::size_t n, std::size_t first, std::size_t len );
+  FlashPeak findPeak( const float* samples, std::size_t n );
+  FlashPeak findPeak( const double* samples, std::size_t n );
+  double gaussianIntegral( const float* samples, std::size_t n, double amp );
+  double gaussianIntegral( const double* samples, std::size_t n, double amp );
+
+  // single-flash helpers; all read flash.waveform
+  double flashArea( const Flash& flash );
+  double flashArea30( const Flash& flash );
+  FlashPeak flashPeak( const Flash& flash );
+  double flashGausIntegral( const Flash& flash );
+
+  // fills area, area30, fcomp_gausintegral and, if the waveform is non-empty, tmax/maxamp
+  void fillIntegrals( Flash& flash );
+
+  // batch variants over a whole list, in list order
+  void fillIntegrals( FlashList& flashes );
+  void fillIntegrals( std::vector< Flash >& flashes );
+
+  const std::size_t kArea30Window = 30; // samples summed into Flash::area30
+
+}
+
+#endif
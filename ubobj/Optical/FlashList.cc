@@ -1,6 +1,7 @@
 #include "FlashList.hh"
 #include <algorithm>
 #include <iostream>
+#include <utility>
 
 #ifdef __BUILD_ROOT_DICT__
 ClassImp( subevent::FlashList )
@@ -8,7 +9,9 @@ ClassImp( subevent::FlashList )
 
 namespace subevent {
 
-  FlashList::FlashList() {
+  FlashList::FlashList() :
+    sortMethod( kUnsorted )
+  {
     fFlashes.reserve(100);
   }
   FlashList::~FlashList() {
@@ -16,7 +19,8 @@ namespace subevent {
   }
 
   int FlashList::add( Flash&& opflash ) {
-    fFlashes.emplace_back( opflash );
+    fFlashes.emplace_back( std::move( opflash ) );
+    sortMethod = kUnsorted;
     return fFlashes.size();
   }
 
@@ -37,19 +41,105 @@ namespace subevent {
     add( std::move(aflash) );
   }
 
+  // the sorts are no-ops when the list is already in order: checking costs
+  // n comparisons, re-sorting costs n log n copies of whole Flash objects
+
   void FlashList::sortByTime() {
+    if ( std::is_sorted( begin(), end(), FlashList::compareTime ) ) {
+      sortMethod = kByTime;
+      return;
+    }
     std::sort( begin(), end(), FlashList::compareTime );
     sortMethod = kByTime;
   }
 
   void FlashList::sortByCharge() {
+    if ( std::is_sorted( begin(), end(), FlashList::compareArea ) ) {
+      sortMethod = kByCharge;
+      return;
+    }
     std::sort( begin(), end(), FlashList::compareArea );
     sortMethod = kByCharge;
   }
 
   void FlashList::sortByAmp() {
+    if ( std::is_sorted( begin(), end(), FlashList::compareAmp ) ) {
+      sortMethod = kByAmp;
+      return;
+    }
     std::sort( begin(), end(), FlashList::compareAmp );
     sortMethod = kByAmp;
   }
 
+  double FlashList::sortKey( const Flash& flash, SortMethod_t key ) {
+    switch ( key ) {
+    case kByTime:   return flash.tstart;
+    case kByCharge: return flash.area;
+    case kByAmp:    return flash.maxamp;
+    default:        return 0.0;
+    }
+  }
+
+  bool FlashList::inOrder( SortMethod_t key ) const {
+    if ( sortMethod!=key || key==kUnsorted ) return false;
+    return std::is_sorted( fFlashes.begin(), fFlashes.end(),
+			   [key]( const Flash& a, const Flash& b ) { return sortKey( a, key )<sortKey( b, key ); } );
+  }
+
+  std::vector< int > FlashList::topK( int k, SortMethod_t key ) const {
+    int n = fFlashes.size();
+    k = std::max( 0, std::min( k, n ) );
+    std::vector< int > idx;
+    idx.reserve( n );
+
+    // already in order: the largest are simply the tail
+    if ( inOrder( key ) ) {
+      for ( int i=n-1; i>=n-k; i-- )
+	idx.push_back( i );
+      return idx;
+    }
+
+    // keys are copied out once so the selection works on a flat array
+    std::vector< double > keys( n );
+    for ( int i=0; i<n; i++ ) {
+      keys[i] = sortKey( fFlashes[i], key );
+      idx.push_back( i );
+    }
+    // ties go to the later flash, the order the tail of a sorted list gives
+    auto larger = [&keys]( int a, int b ) { return keys[a]>keys[b] || ( keys[a]==keys[b] && a>b ); };
+    std::partial_sort( idx.begin(), idx.begin()+k, idx.end(), larger );
+    idx.resize( k );
+    return idx;
+  }
+
+  int FlashList::nthElement( int n, SortMethod_t key ) const {
+    int size = fFlashes.size();
+    if ( n<0 || n>=size ) return -1;
+    if ( inOrder( key ) )
+      return size-1-n;
+
+    std::vector< double > keys( size );
+    std::vector< int > idx( size );
+    for ( int i=0; i<size; i++ ) {
+      keys[i] = sortKey( fFlashes[i], key );
+      idx[i] = i;
+    }
+    auto larger = [&keys]( int a, int b ) { return keys[a]>keys[b] || ( keys[a]==keys[b] && a>b ); };
+    std::nth_element( idx.begin(), idx.begin()+n, idx.end(), larger );
+    return idx[n];
+  }
+
+  Flash* FlashList::largest( SortMethod_t key ) {
+    if ( fFlashes.empty() ) return nullptr;
+    if ( inOrder( key ) )
+      return &fFlashes.back();
+    int ibest = 0;
+    double best = sortKey( fFlashes[0], key );
+    for ( int i=1; i<(int)fFlashes.size(); i++ ) {
+      double val = sortKey( fFlashes[i], key );
+      if ( val>=best ) { best = val; ibest = i; }
+    }
+    return &fFlashes[ibest];
+  }
+
 }
@@ -10,6 +10,7 @@
 namespace subevent {
 
   typedef std::vector< Flash >::iterator FlashListIter;
+  typedef std::vector< Flash >::const_iterator FlashListConstIter;
 #ifdef __BUILD_ROOT_DICT__
   class FlashList : public TObject { 
 #else
@@ -17,33 +18,53 @@ namespace subevent {
 #endif
 
   public:
+    typedef enum { kUnsorted=-1, kByTime, kByCharge, kByAmp } SortMethod_t;
+
     FlashList();
     ~FlashList();
     
 #ifndef __CINT__ // hide from rootcint
 #ifndef __GCCXML__
-    int add( Flash&& opflash );
+    FlashList( const FlashList& orig ) = default;
+    FlashList( FlashList&& orig ) = default;
+    FlashList& operator=( const FlashList& orig ) = default;
+    FlashList& operator=( FlashList&& orig ) = default;
+    int add( Flash&& opflash ); // moves the flash in
 #endif
 #endif
     Flash& get( int i );
     FlashListIter begin();
     FlashListIter end();
+    FlashListConstIter begin() const { return fFlashes.begin(); };
+    FlashListConstIter end() const { return fFlashes.end(); };
     void sortByTime();
     void sortByCharge();
     void sortByAmp();
     int size() { return fFlashes.size(); };
-    void clear() { fFlashes.clear(); fFlashes.reserve(20); };
+    void clear() { fFlashes.clear(); fFlashes.reserve(20); sortMethod = kUnsorted; };
     bool sortedByTime() { if (sortMethod==kByTime) return true; else return false; }; 
     bool sortedByCharge() { if (sortMethod==kByCharge) return true; else return false; }; 
     bool sortedByAmp() { if (sortMethod==kByAmp) return true; else return false; }; 
     void transferFlash( Flash& flash ); // wrapper around add for cython
 
+    // selection without sorting the flashes themselves.
+    // "largest" is in the order the sortBy methods use (ascending tstart, area, maxamp),
+    // so for kByTime it means latest; among equal keys the later flash counts as larger.
+    // Only indices are moved, never Flash objects.
+    std::vector< int > topK( int k, SortMethod_t key ) const; // indices of the k largest, largest first
+    int nthElement( int n, SortMethod_t key ) const;          // index of the n-th largest (0 = largest), -1 if out of range
+    Flash* largest( SortMethod_t key );                       // nullptr if empty
+
   protected:
     std::vector< Flash > fFlashes;
 
-    typedef enum { kUnsorted=-1, kByTime, kByCharge, kByAmp } SortMethod_t;
     SortMethod_t sortMethod;
 
+    static double sortKey( const Flash& flash, SortMethod_t key );
+    // sortMethod==key, confirmed against the flashes: get() and begin() hand out
+    // mutable flashes, so the keys may have changed since the last sort
+    bool inOrder( SortMethod_t key ) const;
+
     static bool compareTime( Flash& t1, Flash& t2 ) {
       if (t1.tstart<t2.tstart )
 	return true;
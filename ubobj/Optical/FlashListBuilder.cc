@@ -0,0 +1,58 @@
+#include "FlashListBuilder.hh"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace subevent {
+
+  int FlashListBuilder::Segment::add( Flash&& opflash ) {
+    // a full chunk is never grown, so flashes already stored stay put
+    if ( fChunks.empty() || fChunks.back().size()==fChunkSize ) {
+      fChunks.emplace_back();
+      fChunks.back().reserve( fChunkSize );
+    }
+    fChunks.back().emplace_back( std::move( opflash ) );
+    return ++fSize;
+  }
+
+  FlashListBuilder::FlashListBuilder( int nproducers, std::size_t chunkSize ) {
+    if ( nproducers<=0 || chunkSize==0 )
+      throw std::invalid_argument( "FlashListBuilder: need at least one producer and a non-zero chunk size" );
+    fSegments.reserve( nproducers );
+    for ( int i=0; i<nproducers; i++ )
+      fSegments.emplace_back( chunkSize );
+  }
+
+  std::size_t FlashListBuilder::size() const {
+    std::size_t n = 0;
+    for ( auto const& seg : fSegments ) n += seg.size();
+    return n;
+  }
+
+  void FlashListBuilder::clear() {
+    for ( auto& seg : fSegments ) seg.clear();
+  }
+
+  int FlashListBuilder::mergeInto( FlashList& out, bool timeOrdered ) {
+    std::vector< Flash* > order;
+    order.reserve( size() );
+    for ( auto& seg : fSegments )
+      for ( auto& chunk : seg.fChunks )
+	for ( auto& flash : chunk )
+	  order.push_back( &flash );
+
+    // sort pointers, not flashes
+    if ( timeOrdered )
+      std::stable_sort( order.begin(), order.end(),
+			[]( const Flash* a, const Flash* b ) { return a->tstart<b->tstart; } );
+
+    for ( Flash* flash : order )
+      out.add( std::move( *flash ) );
+    if ( timeOrdered )
+      out.sortByTime(); // only a check when out started empty or time-ordered
+
+    clear();
+    return out.size();
+  }
+
+}
@@ -0,0 +1,58 @@
+#ifndef __FLASHLISTBUILDER__
+#define __FLASHLISTBUILDER__
+
+#include "Flash.hh"
+#include "FlashList.hh"
+#include <cstddef>
+#include <vector>
+
+// Multi-producer builder for one event's FlashList.
+//
+// The builder is created with a fixed number of producers. Producer i only
+// ever touches segment(i), so filling needs no mutex and no shared atomics;
+// segments are cache-line aligned so neighbouring producers do not share
+// lines. Each segment stores its flashes in fixed-capacity chunks, so growing
+// it never relocates flashes already added.
+//
+// After all producers are joined, mergeInto() appends everything to a
+// FlashList in producer order, or ordered by tstart (ties keep producer
+// order) if requested. mergeInto() must not run concurrently with add().
+
+namespace subevent {
+
+  class FlashListBuilder {
+
+  public:
+
+    class alignas(64) Segment {
+    public:
+      explicit Segment( std::size_t chunkSize=64 ) : fChunkSize( chunkSize ), fSize( 0 ) {};
+      int add( Flash&& opflash );
+      std::size_t size() const { return fSize; };
+      void clear() { fChunks.clear(); fSize = 0; };
+    private:
+      friend class FlashListBuilder;
+      std::size_t fChunkSize;
+      std::size_t fSize;
+      std::vector< std::vector< Flash > > fChunks;
+    };
+
+    FlashListBuilder( int nproducers, std::size_t chunkSize=64 );
+
+    Segment& segment( int producer ) { return fSegments.at( producer ); };
+    int nproducers() const { return fSegments.size(); };
+    std::size_t size() const;
+
+    // appends all flashes to out and clears the segments; returns the new size of out
+    int mergeInto( FlashList& out, bool timeOrdered=false );
+
+    void clear();
+
+  protected:
+    std::vector< Segment > fSegments;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "FlatSubEventList.hh"
+#include <stdexcept>
+#include <string>
+
+namespace subevent {
+
+  FlatSubEventList::FlatSubEventList() :
+    runid( -1 ), subrunid( -1 ), eventid( -1 )
+  {}
+
+  FlatSubEventList::FlatSubEventList( const std::vector< SubEvent >& subevents_ ) :
+    runid( -1 ), subrunid( -1 ), eventid( -1 )
+  {
+    fill( subevents_ );
+  }
+
+  void FlatSubEventList::clear() {
+    runid = subrunid = eventid = -1;
+    subevents.clear();
+    flashes.clear();
+    waveforms.clear();
+    expectations.clear();
+  }
+
+  void FlatSubEventList::fill( const std::vector< SubEvent >& subevents_ ) {
+    // the ids are stored once, so every subevent must come from the same event
+    for ( auto const& subevent : subevents_ ) {
+      if ( subevent.runid!=subevents_.front().runid || subevent.subrunid!=subevents_.front().subrunid
+	   || subevent.eventid!=subevents_.front().eventid )
+	throw std::invalid_argument( "FlatSubEventList: subevents from more than one event (run "
+				     + std::to_string( subevents_.front().runid ) + " and " + std::to_string( subevent.runid ) + ")" );
+    }
+    clear();
+    if ( subevents_.empty() ) return;
+
+    // size everything up front so the pools are allocated once
+    std::size_t nflashes = 0, nwfm = 0, nexp = 0;
+    for ( auto const& subevent : subevents_ ) {
+      for ( const FlashList* fl : { &subevent.flashes, &subevent.flashes_pass2 } ) {
+	for ( FlashListConstIter it=fl->begin(); it!=fl->end(); it++ ) {
+	  nflashes++;
+	  nwfm += it->waveform.size();
+	  nexp += it->expectation.size();
+	}
+      }
+    }
+    subevents.reserve( subevents_.size() );
+    flashes.reserve( nflashes );
+    waveforms.reserve( nwfm );
+    expectations.reserve( nexp );
+
+    runid = subevents_.front().runid;
+    subrunid = subevents_.front().subrunid;
+    eventid = subevents_.front().eventid;
+
+    for ( auto const& subevent : subevents_ ) {
+      FlatSubEvent flat;
+      flat.tstart_sample = subevent.tstart_sample;
+      flat.tend_sample = subevent.tend_sample;
+      flat.tmax_sample = subevent.tmax_sample;
+      flat.tstart_ns = subevent.tstart_ns;
+      flat.tend_ns = subevent.tend_ns;
+      flat.tmax_ns = subevent.tmax_ns;
+      flat.maxamp = subevent.maxamp;
+      flat.totpe = subevent.totpe;
+      flat.pe30 = subevent.pe30;
+      flat.totpe_1 = subevent.totpe_1;
+      flat.pe30_1 = subevent.pe30_1;
+      flat.sumflash30 = subevent.sumflash30;
+      flat.sumfcomp_gausintegral = subevent.sumfcomp_gausintegral;
+      appendFlashes( subevent.flashes, flat.pass1_begin, flat.pass1_end );
+      appendFlashes( subevent.flashes_pass2, flat.pass2_begin, flat.pass2_end );
+      subevents.push_back( flat );
+    }
+  }
+
+  void FlatSubEventList::appendFlashes( const FlashList& flashlist, uint32_t& begin, uint32_t& end ) {
+    begin = flashes.size();
+    for ( FlashListConstIter it=flashlist.begin(); it!=flashlist.end(); it++ ) {
+      FlatFlash flat;
+      flat.ch = it->ch;
+      flat.tstart = it->tstart;
+      flat.tend = it->tend;
+      flat.tmax = it->tmax;
+      flat.maxamp = it->maxamp;
+      flat.area = it->area;
+      flat.area30 = it->area30;
+      flat.fcomp_gausintegral = it->fcomp_gausintegral;
+      flat.claimed = it->claimed;
+      flat.waveform_begin = waveforms.size();
+      flat.waveform_size = it->waveform.size();
+      waveforms.insert( waveforms.end(), it->waveform.begin(), it->waveform.end() );
+      flat.expectation_begin = expectations.size();
+      flat.expectation_size = it->expectation.size();
+      expectations.insert( expectations.end(), it->expectation.begin(), it->expectation.end() );
+      flashes.push_back( flat );
+    }
+    end = flashes.size();
+  }
+
+  Flash FlatSubEventList::getFlash( std::size_t iflash ) const {
+    const FlatFlash& flat = flashes.at( iflash );
+    Flash flash;
+    flash.ch = flat.ch;
+    flash.tstart = flat.tstart;
+    flash.tend = flat.tend;
+    flash.tmax = flat.tmax;
+    flash.maxamp = flat.maxamp;
+    flash.area = flat.area;
+    flash.area30 = flat.area30;
+    flash.fcomp_gausintegral = flat.fcomp_gausintegral;
+    flash.claimed = flat.claimed;
+    auto wfm = waveforms.begin() + flat.waveform_begin;
+    flash.waveform.assign( wfm, wfm + flat.waveform_size );
+    auto exp = expectations.begin() + flat.expectation_begin;
+    flash.expectation.assign( exp, exp + flat.expectation_size );
+    return flash;
+  }
+
+  FlashList FlatSubEventList::getFlashes( uint32_t begin, uint32_t end ) const {
+    FlashList flashlist;
+    for ( uint32_t i=begin; i<end; i++ )
+      flashlist.add( getFlash( i ) );
+    return flashlist;
+  }
+
+  SubEvent FlatSubEventList::getSubEvent( std::size_t i ) const {
+    const FlatSubEvent& flat = subevents.at( i );
+    SubEvent subevent;
+    subevent.tstart_sample = flat.tstart_sample;
+    subevent.tend_sample = flat.tend_sample;
+    subevent.tmax_sample = flat.tmax_sample;
+    subevent.tstart_ns = flat.tstart_ns;
+    subevent.tend_ns = flat.tend_ns;
+    subevent.tmax_ns = flat.tmax_ns;
+    subevent.maxamp = flat.maxamp;
+    subevent.totpe = flat.totpe;
+    subevent.pe30 = flat.pe30;
+    subevent.totpe_1 = flat.totpe_1;
+    subevent.pe30_1 = flat.pe30_1;
+    subevent.sumflash30 = flat.sumflash30;
+    subevent.sumfcomp_gausintegral = flat.sumfcomp_gausintegral;
+    subevent.runid = runid;
+    subevent.subrunid = subrunid;
+    subevent.eventid = eventid;
+    subevent.flashes = getFlashes( flat.pass1_begin, flat.pass1_end );
+    subevent.flashes_pass2 = getFlashes( flat.pass2_begin, flat.pass2_end );
+    return subevent;
+  }
+
+  std::vector< SubEvent > FlatSubEventList::toSubEvents() const {
+    std::vector< SubEvent > out;
+    out.reserve( subevents.size() );
+    for ( std::size_t i=0; i<subevents.size(); i++ )
+      out.push_back( getSubEvent( i ) );
+    return out;
+  }
+
+}
@@ -0,0 +1,92 @@
+#ifndef __FLATSUBEVENTLIST__
+#define __FLATSUBEVENTLIST__
+
+#include "Flash.hh"
+#include "FlashList.hh"
+#include "SubEvent.hh"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact persistent form of std::vector<subevent::SubEvent>.
+// All flashes of all subevents live in one flash table; each subevent keeps
+// [begin,end) ranges into it for its first- and second-pass lists.
+// Waveforms and expectations are concatenated into float32 pools, and the
+// run/subrun/event ids are stored once for the whole product.
+// No TObject base: this is meant to be streamed by art only.
+
+namespace subevent {
+
+  struct FlatFlash {
+    int ch;
+    int tstart;
+    int tend;
+    int tmax;
+    float maxamp;
+    float area;
+    float area30;
+    float fcomp_gausintegral;
+    bool claimed;
+    uint32_t waveform_begin;     // offset into FlatSubEventList::waveforms
+    uint32_t waveform_size;
+    uint32_t expectation_begin;  // offset into FlatSubEventList::expectations
+    uint32_t expectation_size;
+  };
+
+  struct FlatSubEvent {
+    int tstart_sample;
+    int tend_sample;
+    int tmax_sample;
+    double tstart_ns;
+    double tend_ns;
+    double tmax_ns;
+    double maxamp;
+    double totpe;
+    double pe30;
+    double totpe_1;
+    double pe30_1;
+    double sumflash30;
+    double sumfcomp_gausintegral;
+    uint32_t pass1_begin;  // first pass flashes are flashes[pass1_begin,pass1_end)
+    uint32_t pass1_end;
+    uint32_t pass2_begin;  // second pass flashes are flashes[pass2_begin,pass2_end)
+    uint32_t pass2_end;
+  };
+
+  class FlatSubEventList {
+
+  public:
+    FlatSubEventList();
+    explicit FlatSubEventList( const std::vector< SubEvent >& subevents );
+
+    // write side: replaces the current content. The subevents must share one
+    // run/subrun/event id; mixed input throws std::invalid_argument and leaves
+    // the list unchanged.
+    void fill( const std::vector< SubEvent >& subevents );
+    void clear();
+
+    // read-side adapters back to the full classes
+    std::size_t size() const { return subevents.size(); };
+    std::size_t flashCount() const { return flashes.size(); };
+    Flash getFlash( std::size_t iflash ) const;
+    FlashList getFlashes( uint32_t begin, uint32_t end ) const;
+    SubEvent getSubEvent( std::size_t i ) const;
+    std::vector< SubEvent > toSubEvents() const;
+
+    int runid;
+    int subrunid;
+    int eventid;
+
+    std::vector< FlatSubEvent > subevents;
+    std::vector< FlatFlash > flashes;
+    std::vector< float > waveforms;
+    std::vector< float > expectations;
+
+  private:
+    void appendFlashes( const FlashList& flashlist, uint32_t& begin, uint32_t& end );
+
+  };
+
+}
+
+#endif
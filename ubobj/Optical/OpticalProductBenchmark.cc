@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////////////////
+//
+// OpticalProductBenchmark
+//
+// Times building, sorting, copying, flattening and ROOT-streaming
+// synthetic subevent::SubEvent collections, and counts heap allocations
+// per event through a replaced global operator new.
+//
+// usage: OpticalProductBenchmark [--events N] [--subevents N] [--flashes N]
+//                                [--samples N] [--seed N] [--format json|csv]
+//
+// One result line per operation is written to stdout, either as JSON
+// objects (one per line) or as CSV with a header.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "ubobj/Optical/Flash.hh"
+#include "ubobj/Optical/FlashList.hh"
+#include "ubobj/Optical/SubEvent.hh"
+#include "ubobj/Optical/SubEventList.hh"
+#include "ubobj/Optical/FlatSubEventList.hh"
+#include "ubobj/Optical/FlashIntegrals.hh"
+
+#include "TBufferFile.h"
+#include "TClass.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------
+// allocation counting
+
+namespace {
+  std::atomic< unsigned long > gAllocCount( 0 );
+  std::atomic< unsigned long > gAllocBytes( 0 );
+}
+
+// kept out of line so gcc does not pair the inlined malloc/free with new/delete
+[[gnu::noinline]] void* operator new( std::size_t size ) {
+  gAllocCount.fetch_add( 1, std::memory_order_relaxed );
+  gAllocBytes.fetch_add( size, std::memory_order_relaxed );
+  if ( void* p = std::malloc( size ? size : 1 ) ) return p;
+  throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete( void* p ) noexcept { std::free( p ); }
+[[gnu::noinline]] void operator delete( void* p, std::size_t ) noexcept { std::free( p ); }
+
+//-----------------------------------------------------------------------------------
+
+namespace {
+
+  struct Config {
+    int events = 100;
+    int subevents = 10;
+    int flashes = 32;     // per pass, per subevent
+    int samples = 100;    // waveform length
+    unsigned seed = 12345;
+    bool json = true;
+  };
+
+  struct Result {
+    std::string op;
+    double ns_per_event;
+    double allocs_per_event;
+    double bytes_per_event;
+  };
+
+  subevent::Flash makeFlash( std::mt19937& rng, int ch, int samples ) {
+    std::uniform_int_distribution< int > tdist( 0, 20000 );
+    std::normal_distribution< double > noise( 0.0, 0.5 );
+    int tstart = tdist( rng );
+    double amp = 5.0 + 50.0*std::generate_canonical< double, 32 >( rng );
+    std::vector< double > waveform( samples ), expectation( samples );
+    for ( int i=0; i<samples; i++ ) {
+      double x = ( i-10 )/4.0;
+      expectation[i] = amp*std::exp( -0.5*x*x );
+      waveform[i] = expectation[i] + noise( rng );
+    }
+    subevent::Flash flash( ch, tstart, tstart+samples, tstart+10, amp, expectation, waveform );
+    subevent::fillIntegrals( flash );
+    return flash;
+  }
+
+  std::vector< subevent::SubEvent > makeEvent( std::mt19937& rng, const Config& cfg ) {
+    std::vector< subevent::SubEvent > event( cfg.subevents );
+    for ( auto& subevent : event ) {
+      subevent.runid = 1;
+      subevent.subrunid = 1;
+      subevent.eventid = 1;
+      for ( int f=0; f<cfg.flashes; f++ ) {
+	subevent.flashes.add( makeFlash( rng, f%32, cfg.samples ) );
+	subevent.flashes_pass2.add( makeFlash( rng, f%32, cfg.samples ) );
+      }
+    }
+    return event;
+  }
+
+  // runs op once per event and reports the averages
+  Result measure( const std::string& name, int nevents, const std::function< void( int ) >& op ) {
+    unsigned long count0 = gAllocCount.load();
+    unsigned long bytes0 = gAllocBytes.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for ( int i=0; i<nevents; i++ ) op( i );
+    auto t1 = std::chrono::steady_clock::now();
+    Result r;
+    r.op = name;
+    r.ns_per_event = std::chrono::duration< double, std::nano >( t1-t0 ).count()/nevents;
+    r.allocs_per_event = double( gAllocCount.load()-count0 )/nevents;
+    r.bytes_per_event = double( gAllocBytes.load()-bytes0 )/nevents;
+    return r;
+  }
+
+  void report( const std::vector< Result >& results, const Config& cfg ) {
+    if ( !cfg.json )
+      std::printf( "op,events,subevents,flashes,samples,ns_per_event,allocs_per_event,bytes_per_event\n" );
+    for ( auto const& r : results ) {
+      if ( cfg.json )
+	std::printf( "{\"op\":\"%s\",\"events\":%d,\"subevents\":%d,\"flashes\":%d,\"samples\":%d,"
+		     "\"ns_per_event\":%.1f,\"allocs_per_event\":%.1f,\"bytes_per_event\":%.1f}\n",
+		     r.op.c_str(), cfg.events, cfg.subevents, cfg.flashes, cfg.samples,
+		     r.ns_per_event, r.allocs_per_event, r.bytes_per_event );
+      else
+	std::printf( "%s,%d,%d,%d,%d,%.1f,%.1f,%.1f\n",
+		     r.op.c_str(), cfg.events, cfg.subevents, cfg.flashes, cfg.samples,
+		     r.ns_per_event, r.allocs_per_event, r.bytes_per_event );
+    }
+  }
+
+  bool parseArgs( int argc, char** argv, Config& cfg ) {
+    for ( int i=1; i<argc; i++ ) {
+      std::string arg = argv[i];
+      if ( i+1>=argc ) return false;
+      std::string val = argv[++i];
+      if ( arg=="--events" ) cfg.events = std::stoi( val );
+      else if ( arg=="--subevents" ) cfg.subevents = std::stoi( val );
+      else if ( arg=="--flashes" ) cfg.flashes = std::stoi( val );
+      else if ( arg=="--samples" ) cfg.samples = std::stoi( val );
+      else if ( arg=="--seed" ) cfg.seed = std::stoul( val );
+      else if ( arg=="--format" ) cfg.json = ( val!="csv" );
+      else return false;
+    }
+    return cfg.events>0;
+  }
+
+}
+
+//-----------------------------------------------------------------------------------
+
+int main( int argc, char** argv ) {
+
+  Config cfg;
+  if ( !parseArgs( argc, argv, cfg ) ) {
+    std::fprintf( stderr, "usage: %s [--events N] [--subevents N] [--flashes N] [--samples N] [--seed N] [--format json|csv]\n", argv[0] );
+    return 1;
+  }
+
+  std::mt19937 rng( cfg.seed );
+  std::vector< std::vector< subevent::SubEvent > > events( cfg.events );
+  std::vector< Result > results;
+
+  results.push_back( measure( "build", cfg.events, [&]( int i ) {
+	events[i] = makeEvent( rng, cfg );
+      } ) );
+
+  results.push_back( measure( "integrals", cfg.events, [&]( int i ) {
+	for ( auto& subevent : events[i] ) {
+	  subevent::fillIntegrals( subevent.flashes );
+	  subevent::fillIntegrals( subevent.flashes_pass2 );
+	}
+      } ) );
+
+  results.push_back( measure( "sort_by_charge", cfg.events, [&]( int i ) {
+	for ( auto& subevent : events[i] ) {
+	  subevent.flashes.sortByCharge();
+	  subevent.flashes_pass2.sortByCharge();
+	}
+      } ) );
+
+  results.push_back( measure( "sort_by_time", cfg.events, [&]( int i ) {
+	for ( auto& subevent : events[i] ) {
+	  subevent.flashes.sortByTime();
+	  subevent.flashes_pass2.sortByTime();
+	}
+      } ) );
+
+  results.push_back( measure( "top1_by_charge", cfg.events, [&]( int i ) {
+	for ( auto& subevent : events[i] )
+	  subevent.flashes.topK( 1, subevent::FlashList::kByCharge );
+      } ) );
+
+  results.push_back( measure( "copy", cfg.events, [&]( int i ) {
+	std::vector< subevent::SubEvent > copy( events[i] );
+      } ) );
+
+  results.push_back( measure( "subeventlist_add", cfg.events, [&]( int i ) {
+	subevent::SubEventList list;
+	for ( auto const& subevent : events[i] )
+	  list.add( subevent::SubEvent( subevent ) );
+      } ) );
+
+  results.push_back( measure( "flatten", cfg.events, [&]( int i ) {
+	subevent::FlatSubEventList flat( events[i] );
+      } ) );
+
+  results.push_back( measure( "unflatten", cfg.events, [&]( int i ) {
+	subevent::FlatSubEventList flat( events[i] );
+	std::vector< subevent::SubEvent > back = flat.toSubEvents();
+      } ) );
+
+  // ROOT streaming goes through the dictionaries, so it is skipped when
+  // they cannot be loaded
+  TClass* vecClass = TClass::GetClass( "std::vector<subevent::SubEvent>" );
+  TClass* flatClass = TClass::GetClass( "subevent::FlatSubEventList" );
+  if ( vecClass && vecClass->IsLoaded() ) {
+    results.push_back( measure( "root_write", cfg.events, [&]( int i ) {
+	  TBufferFile buf( TBuffer::kWrite );
+	  buf.WriteObjectAny( &events[i], vecClass );
+	} ) );
+    results.push_back( measure( "root_write_read", cfg.events, [&]( int i ) {
+	  TBufferFile buf( TBuffer::kWrite );
+	  buf.WriteObjectAny( &events[i], vecClass );
+	  buf.SetReadMode();
+	  buf.SetBufferOffset( 0 );
+	  void* obj = buf.ReadObjectAny( vecClass );
+	  vecClass->Destructor( obj );
+	} ) );
+  }
+  if ( flatClass && flatClass->IsLoaded() ) {
+    results.push_back( measure( "root_write_flat", cfg.events, [&]( int i ) {
+	  subevent::FlatSubEventList flat( events[i] );
+	  TBufferFile buf( TBuffer::kWrite );
+	  buf.WriteObjectAny( &flat, flatClass );
+	} ) );
+  }
+
+  report( results, cfg );
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "OpticalSummary.hh"
+
+namespace subevent {
+
+  OpticalSummary::OpticalSummary() :
+    beamPE( 0.0 ), totalPE( 0.0 ), nSubEventsInBeam( 0 ),
+    brightestSubEvent( -1 ), brightestFlashSubEvent( -1 ), brightestFlash( -1 ), brightestFlashPE( 0.0 ),
+    nFlashesAboveThreshold( 0 ), nFlashesAboveThreshold_pass2( 0 )
+  {}
+
+  OpticalSummary::OpticalSummary( const std::vector< SubEvent >& subevents, const OpticalSummaryConfig& cfg ) :
+    OpticalSummary()
+  {
+    double maxpe = 0.0;
+    for ( std::size_t i=0; i<subevents.size(); i++ ) {
+      const SubEvent& subevent = subevents[i];
+      totalPE += subevent.totpe;
+      if ( subevent.tstart_ns>=cfg.beamStart_ns && subevent.tstart_ns<cfg.beamEnd_ns ) {
+	beamPE += subevent.totpe;
+	nSubEventsInBeam++;
+      }
+      if ( brightestSubEvent<0 || subevent.totpe>maxpe ) {
+	maxpe = subevent.totpe;
+	brightestSubEvent = i;
+      }
+      accumulateFlashes( subevent.flashes, i, cfg, nFlashesAboveThreshold );
+      for ( FlashListConstIter it=subevent.flashes_pass2.begin(); it!=subevent.flashes_pass2.end(); it++ )
+	if ( it->area>cfg.flashPEThreshold ) nFlashesAboveThreshold_pass2++;
+    }
+  }
+
+  OpticalSummary::OpticalSummary( const FlashList& flashes, const OpticalSummaryConfig& cfg ) :
+    OpticalSummary()
+  {
+    for ( FlashListConstIter it=flashes.begin(); it!=flashes.end(); it++ ) {
+      double t = it->tstart*cfg.nsPerSample;
+      totalPE += it->area;
+      if ( t>=cfg.beamStart_ns && t<cfg.beamEnd_ns )
+	beamPE += it->area;
+    }
+    accumulateFlashes( flashes, -1, cfg, nFlashesAboveThreshold );
+  }
+
+  void OpticalSummary::accumulateFlashes( const FlashList& flashes, int subevent, const OpticalSummaryConfig& cfg, int& count ) {
+    int i = 0;
+    for ( FlashListConstIter it=flashes.begin(); it!=flashes.end(); it++, i++ ) {
+      if ( it->area>cfg.flashPEThreshold ) count++;
+      if ( brightestFlash<0 || it->area>brightestFlashPE ) {
+	brightestFlashPE = it->area;
+	brightestFlash = i;
+	brightestFlashSubEvent = subevent;
+      }
+    }
+  }
+
+  std::shared_ptr< OpticalSummaryCache::Entry > OpticalSummaryCache::entry( const OpticalSummaryKey& key ) {
+    const uint64_t now = fClock.fetch_add( 1, std::memory_order_relaxed )+1;
+    {
+      std::shared_lock< std::shared_mutex > lock( fMutex );
+      auto it = fEntries.find( key );
+      if ( it!=fEntries.end() ) {
+	it->second->lastUse.store( now, std::memory_order_relaxed );
+	return it->second;
+      }
+    }
+    std::unique_lock< std::shared_mutex > lock( fMutex );
+    std::shared_ptr< Entry >& e = fEntries[key];
+    if ( !e ) e = std::make_shared< Entry >();
+    e->lastUse.store( now, std::memory_order_relaxed );
+    std::shared_ptr< Entry > found = e;
+
+    // over capacity: drop the least recently used entries; the map is small, so a scan will do
+    while ( fEntries.size()>fCapacity ) {
+      auto oldest = fEntries.end();
+      for ( auto it=fEntries.begin(); it!=fEntries.end(); it++ ) {
+	if ( it->second==found ) continue;
+	if ( oldest==fEntries.end() || it->second->lastUse.load( std::memory_order_relaxed )<oldest->second->lastUse.load( std::memory_order_relaxed ) )
+	  oldest = it;
+      }
+      fEntries.erase( oldest );
+    }
+    return found;
+  }
+
+  std::size_t OpticalSummaryCache::size() {
+    std::shared_lock< std::shared_mutex > lock( fMutex );
+    return fEntries.size();
+  }
+
+  std::shared_ptr< const OpticalSummary > OpticalSummaryCache::get( const OpticalSummaryKey& key, const std::vector< SubEvent >& subevents ) {
+    return getImpl( key, subevents );
+  }
+
+  std::shared_ptr< const OpticalSummary > OpticalSummaryCache::get( const OpticalSummaryKey& key, const FlashList& flashes ) {
+    return getImpl( key, flashes );
+  }
+
+  void OpticalSummaryCache::clear() {
+    std::unique_lock< std::shared_mutex > lock( fMutex );
+    fEntries.clear();
+  }
+
+}
@@ -0,0 +1,120 @@
+#ifndef __OPTICALSUMMARY__
+#define __OPTICALSUMMARY__
+
+#include "Flash.hh"
+#include "FlashList.hh"
+#include "SubEvent.hh"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <vector>
+
+// Event-level optical summary shared between modules.
+//
+// OpticalSummary holds the quantities most analyses recompute from the
+// subevent products: PE in the beam window, the brightest subevent/flash and
+// flash counts above threshold. OpticalSummaryCache memoizes one summary per
+// source product: the first caller computes it, everyone else gets the same
+// read-only object. Lookups take a shared lock and computation runs under
+// std::call_once, so concurrent readers under art multithreading never
+// duplicate the work. Entries are keyed by product and event (see
+// OpticalSummaryKey), so concurrent events share one cache and a product
+// that reuses an old address cannot pick up a stale summary. The cache holds
+// at most capacity() entries: inserting past it evicts the least recently
+// used one, so a long job keeps only the summaries of the events in flight.
+// An evicted summary stays valid for whoever holds it and is recomputed if
+// asked for again. clear() is safe while other threads are reading.
+
+namespace subevent {
+
+  struct OpticalSummaryConfig {
+    double beamStart_ns = 0.0;      // beam window [start,end), in the subevent tstart_ns clock;
+    double beamEnd_ns = 0.0;        // empty by default, set it from the job configuration
+    double nsPerSample = 15.625;    // converts Flash tstart to ns
+    double flashPEThreshold = 0.0;  // flashes with area above this are counted
+  };
+
+  // identifies one source product in one event; with art,
+  // { handle.id().value(), e.run(), e.subRun(), e.event() }
+  struct OpticalSummaryKey {
+    uint32_t product;
+    uint32_t run;
+    uint32_t subRun;
+    uint32_t event;
+
+    bool operator<( const OpticalSummaryKey& other ) const {
+      return std::tie( product, run, subRun, event )<std::tie( other.product, other.run, other.subRun, other.event );
+    };
+  };
+
+  class OpticalSummary {
+
+  public:
+    OpticalSummary();
+    OpticalSummary( const std::vector< SubEvent >& subevents, const OpticalSummaryConfig& cfg );
+    OpticalSummary( const FlashList& flashes, const OpticalSummaryConfig& cfg );
+
+    double beamPE;              // totpe of subevents (or area of flashes) starting in the beam window
+    double totalPE;             // same, over the whole readout
+    int nSubEventsInBeam;
+    int brightestSubEvent;      // index of the largest-totpe subevent, -1 if none
+    int brightestFlashSubEvent; // subevent holding the brightest first-pass flash, -1 for FlashList sources
+    int brightestFlash;         // index of the brightest flash within its list, -1 if none
+    double brightestFlashPE;
+    int nFlashesAboveThreshold;        // first pass
+    int nFlashesAboveThreshold_pass2;  // second pass; 0 for FlashList sources
+
+  private:
+    void accumulateFlashes( const FlashList& flashes, int subevent, const OpticalSummaryConfig& cfg, int& count );
+  };
+
+  class OpticalSummaryCache {
+
+  public:
+    // capacity: entries kept; a few per event being processed concurrently is enough
+    explicit OpticalSummaryCache( const OpticalSummaryConfig& cfg=OpticalSummaryConfig(), std::size_t capacity=64 ) :
+      fConfig( cfg ), fCapacity( capacity>0 ? capacity : 1 ), fClock( 0 ) {};
+
+    // computed on the first call for a given key, shared afterwards; the source
+    // must be the product the key names
+    std::shared_ptr< const OpticalSummary > get( const OpticalSummaryKey& key, const std::vector< SubEvent >& subevents );
+    std::shared_ptr< const OpticalSummary > get( const OpticalSummaryKey& key, const FlashList& flashes );
+
+    void clear();
+    const OpticalSummaryConfig& config() const { return fConfig; };
+    std::size_t capacity() const { return fCapacity; };
+    std::size_t size();
+
+  protected:
+    struct Entry {
+      std::once_flag once;
+      std::shared_ptr< const OpticalSummary > summary;
+      std::atomic< uint64_t > lastUse{ 0 }; // fClock at the last lookup; bumped under the shared lock
+    };
+
+    // shared ownership keeps an entry alive for a reader even if clear() drops it from the map
+    std::shared_ptr< Entry > entry( const OpticalSummaryKey& key );
+
+    template< typename Source >
+    std::shared_ptr< const OpticalSummary > getImpl( const OpticalSummaryKey& key, const Source& source ) {
+      std::shared_ptr< Entry > e = entry( key );
+      std::call_once( e->once, [&]() { e->summary = std::make_shared< const OpticalSummary >( source, fConfig ); } );
+      return e->summary;
+    }
+
+    OpticalSummaryConfig fConfig;
+    std::size_t fCapacity;
+    std::atomic< uint64_t > fClock;
+    std::shared_mutex fMutex;
+    std::map< OpticalSummaryKey, std::shared_ptr< Entry > > fEntries;
+
+  };
+
+}
+
+#endif
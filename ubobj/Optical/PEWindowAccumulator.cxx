@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////
+#include "PEWindowAccumulator.h"
+
+#include <algorithm>
+
+namespace uboone {
+
+  PEWindowAccumulator::PEWindowAccumulator(const std::vector<float>& binnedPE,
+                                           const std::vector<float>& thresholds)
+  {
+    Fill(binnedPE, thresholds);
+  }
+
+  void PEWindowAccumulator::Fill(const std::vector<float>& binnedPE,
+                                 const std::vector<float>& thresholds)
+  {
+    fPE = binnedPE;
+    fThresholds = thresholds;
+    std::size_t n = fPE.size();
+
+    fPrefix.assign(n + 1, 0.);
+    for (std::size_t i = 0; i < n; ++i) fPrefix[i + 1] = fPrefix[i] + fPE[i];
+
+    fPrefixAbove.assign(fThresholds.size(), std::vector<double>(n + 1, 0.));
+    for (std::size_t t = 0; t < fThresholds.size(); ++t) {
+      std::vector<double>& prefix = fPrefixAbove[t];
+      float thresh = fThresholds[t];
+      for (std::size_t i = 0; i < n; ++i)
+        prefix[i + 1] = prefix[i] + (fPE[i] > thresh ? fPE[i] : 0.f);
+    }
+  }
+
+  int PEWindowAccumulator::ThresholdIndex(float threshold) const
+  {
+    for (std::size_t t = 0; t < fThresholds.size(); ++t)
+      if (fThresholds[t] == threshold) return t;
+    return -1;
+  }
+
+  double PEWindowAccumulator::Range(const std::vector<double>& prefix, std::size_t begin, std::size_t end) const
+  {
+    end = std::min(end, fPE.size());
+    if (begin >= end) return 0.;
+    return prefix[end] - prefix[begin];
+  }
+
+  double PEWindowAccumulator::Total(std::size_t begin, std::size_t end) const
+  {
+    return Range(fPrefix, begin, end);
+  }
+
+  double PEWindowAccumulator::AboveThreshold(std::size_t begin, std::size_t end, float threshold) const
+  {
+    int t = ThresholdIndex(threshold);
+    if (t >= 0) return Range(fPrefixAbove[t], begin, end);
+
+    end = std::min(end, fPE.size());
+    double sum = 0.;
+    for (std::size_t i = begin; i < end; ++i)
+      if (fPE[i] > threshold) sum += fPE[i];
+    return sum;
+  }
+
+  UbooneOpticalFilter PEWindowAccumulator::MakeFilter(const Window& beam, const Window& veto,
+                                                      float threshold, float pmtMaxFraction) const
+  {
+    return UbooneOpticalFilter(AboveThreshold(beam, threshold),
+                               AboveThreshold(veto, threshold),
+                               pmtMaxFraction,
+                               Total(beam),
+                               Total(veto));
+  }
+
+} // namespace uboone
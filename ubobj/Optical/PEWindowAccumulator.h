@@ -0,0 +1,69 @@
+/** ****************************************************************************
+ * @file PEWindowAccumulator.h
+ * @brief Prefix-sum accumulator over binned summed-PMT PE
+ *
+ * One O(n) pass over the binned PE builds a prefix sum over all bins and one
+ * per requested threshold ("bins above thresh", PE > threshold). Afterwards
+ * the PE in any [begin,end) bin window is an O(1) lookup, so beam/veto
+ * windows can be re-tuned without re-reading the waveform.
+ * Thresholds not given at construction are still answered, by a direct
+ * scan of the window.
+ *
+ * ****************************************************************************/
+
+#ifndef UBOONEOBJ_PEWINDOWACCUMULATOR_H
+#define UBOONEOBJ_PEWINDOWACCUMULATOR_H
+
+#include "ubobj/Optical/UbooneOpticalFilter.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace uboone {
+
+  class PEWindowAccumulator {
+
+  public:
+
+    struct Window {
+      std::size_t begin; /// first bin
+      std::size_t end;   /// one past the last bin
+    };
+
+    PEWindowAccumulator() {}
+    PEWindowAccumulator(const std::vector<float>& binnedPE,
+                        const std::vector<float>& thresholds = std::vector<float>());
+
+    void Fill(const std::vector<float>& binnedPE,
+              const std::vector<float>& thresholds = std::vector<float>());
+
+    std::size_t NBins() const { return fPE.size(); }
+    const std::vector<float>& Thresholds() const { return fThresholds; }
+
+    /// PE in [begin,end), all bins; windows are clipped to the binned range
+    double Total(std::size_t begin, std::size_t end) const;
+    double Total(const Window& w) const { return Total(w.begin, w.end); }
+
+    /// PE in [begin,end) from bins with PE > threshold; O(1) if the threshold was precomputed
+    double AboveThreshold(std::size_t begin, std::size_t end, float threshold) const;
+    double AboveThreshold(const Window& w, float threshold) const { return AboveThreshold(w.begin, w.end, threshold); }
+
+    /// fills the filter summary for the given windows; max fraction comes from the PMT spectrum
+    UbooneOpticalFilter MakeFilter(const Window& beam, const Window& veto,
+                                   float threshold, float pmtMaxFraction) const;
+
+  private:
+
+    int ThresholdIndex(float threshold) const; /// -1 if not precomputed
+    double Range(const std::vector<double>& prefix, std::size_t begin, std::size_t end) const;
+
+    std::vector<float> fPE;
+    std::vector<float> fThresholds;
+    std::vector<double> fPrefix;                    /// fPrefix[i] = sum of bins [0,i)
+    std::vector< std::vector<double> > fPrefixAbove; /// one prefix per threshold
+
+  }; // class PEWindowAccumulator
+
+} // namespace uboone
+
+#endif // UBOONEOBJ_PEWINDOWACCUMULATOR_H
@@ -0,0 +1,56 @@
+/** ****************************************************************************
+ * @file PMTSpectrum.h
+ * @brief Fixed-size per-PMT PE spectrum with comparison reductions
+ *
+ * Value type for the 32 MicroBooNE PMTs, stored as a 32-byte aligned float
+ * array so the reductions below compile to straight vector code and never
+ * touch the heap. Intended as the working type for flash matching and the
+ * optical filter; persisted products (ubana::FlashMatch, UBXSecEvent, ...)
+ * keep their std::vector<double> and convert at the boundary.
+ *
+ * ****************************************************************************/
+
+#ifndef UBOONEOBJ_PMTSPECTRUM_H
+#define UBOONEOBJ_PMTSPECTRUM_H
+
+#include <cstddef>
+#include <vector>
+
+namespace uboone {
+
+  class alignas(32) PMTSpectrum {
+
+  public:
+
+    static constexpr std::size_t kNPMTs = 32;
+    static constexpr std::size_t kLanes = 8; /// independent accumulators in Max(); divides kNPMTs
+
+    PMTSpectrum() { Clear(); }
+    explicit PMTSpectrum(const std::vector<double>& pe); /// extra entries ignored, missing ones zero
+    explicit PMTSpectrum(const std::vector<float>& pe);
+
+    void Clear();
+    std::vector<double> ToVector() const;
+
+    float& operator[](std::size_t i) { return fPE[i]; }
+    float operator[](std::size_t i) const { return fPE[i]; }
+    const float* data() const { return fPE; }
+    static constexpr std::size_t size() { return kNPMTs; }
+
+    float Sum() const;                                  /// total PE
+    float Max() const;                                  /// largest single-PMT PE
+    float MaxFraction() const;                          /// Max()/Sum(), 0 for an empty spectrum
+    float Dot(const PMTSpectrum& other) const;          /// raw dot product
+    float NormalizedDot(const PMTSpectrum& other) const;/// cosine similarity, 0 if either is empty
+    float Chi2(const PMTSpectrum& hypo) const;          /// sum (this-hypo)^2/hypo over PMTs with hypo>0
+    float KSDistance(const PMTSpectrum& other) const;   /// max |CDF difference| of the normalized spectra
+
+  private:
+
+    float fPE[kNPMTs];
+
+  }; // class PMTSpectrum
+
+} // namespace uboone
+
+#endif // UBOONEOBJ_PMTSPECTRUM_H
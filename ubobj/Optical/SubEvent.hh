@@ -20,6 +20,14 @@ namespace subevent {
     
     SubEvent();
     ~SubEvent();
+#ifndef __CINT__ // hide from rootcint
+#ifndef __GCCXML__
+    SubEvent( const SubEvent& orig ) = default;
+    SubEvent( SubEvent&& orig ) = default;
+    SubEvent& operator=( const SubEvent& orig ) = default;
+    SubEvent& operator=( SubEvent&& orig ) = default;
+#endif
+#endif
 
     int tstart_sample;
     int tend_sample;
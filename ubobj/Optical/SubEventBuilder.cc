@@ -0,0 +1,140 @@
+#include "SubEventBuilder.hh"
+#include <algorithm>
+#include <stdexcept>
+
+namespace subevent {
+
+  SubEventBuilder::SubEventBuilder( int nchannels, int preWindow, int postWindow, double nsPerSample ) :
+    fChannels( nchannels ), fPreWindow( preWindow ), fPostWindow( postWindow ), fNsPerSample( nsPerSample ),
+    fMinSeedAmp( 0.0 ), fRun( -1 ), fSubRun( -1 ), fEvent( -1 ), fUnclaimed1( 0 ), fUnclaimed2( 0 )
+  {}
+
+  void SubEventBuilder::sortByStart( std::vector< Flash >& flashes ) {
+    std::stable_sort( flashes.begin(), flashes.end(),
+		      []( const Flash& a, const Flash& b ) { return a.tstart<b.tstart; } );
+  }
+
+  void SubEventBuilder::setChannel( int ch, FlashList&& pass1, FlashList&& pass2 ) {
+    if ( ch<0 || ch>=(int)fChannels.size() )
+      throw std::out_of_range( "SubEventBuilder::setChannel: channel out of range" );
+
+    // everything here touches only this channel's slot
+    ChannelSlot& slot = fChannels[ch];
+    slot.pass1.assign( std::make_move_iterator( pass1.begin() ), std::make_move_iterator( pass1.end() ) );
+    slot.pass2.assign( std::make_move_iterator( pass2.begin() ), std::make_move_iterator( pass2.end() ) );
+    pass1.clear();
+    pass2.clear();
+    sortByStart( slot.pass1 );
+    sortByStart( slot.pass2 );
+    slot.claimed1.assign( (slot.pass1.size()+63)/64, 0 );
+    slot.claimed2.assign( (slot.pass2.size()+63)/64, 0 );
+  }
+
+  void SubEventBuilder::reset() {
+    for ( auto& slot : fChannels ) {
+      slot.pass1.clear();
+      slot.pass2.clear();
+      slot.claimed1.clear();
+      slot.claimed2.clear();
+    }
+  }
+
+  int SubEventBuilder::claimWindow( std::vector< Flash >& flashes, std::vector< uint64_t >& bits, int t0, int t1, FlashList& out ) {
+    int tend = t0;
+    auto first = std::lower_bound( flashes.begin(), flashes.end(), t0,
+				   []( const Flash& f, int t ) { return f.tstart<t; } );
+    for ( auto it=first; it!=flashes.end() && it->tstart<t1; it++ ) {
+      std::size_t i = it - flashes.begin();
+      if ( isClaimed( bits, i ) ) continue;
+      claim( bits, i );
+      tend = std::max( tend, it->tend );
+      // the bit keeps it from being claimed again, so the slot's copy is not needed;
+      // tstart stays valid for the binary searches of later windows
+      it->claimed = true;
+      out.add( std::move( *it ) );
+    }
+    return tend;
+  }
+
+  int SubEventBuilder::countUnclaimed( const std::vector< Flash >& flashes, const std::vector< uint64_t >& bits ) {
+    int n = 0;
+    for ( std::size_t i=0; i<flashes.size(); i++ )
+      if ( !isClaimed( bits, i ) ) n++;
+    return n;
+  }
+
+  int SubEventBuilder::build( SubEventList& subevents ) {
+
+    // seeds in a fixed order independent of which task finished first
+    std::vector< Seed > seeds;
+    for ( std::size_t ch=0; ch<fChannels.size(); ch++ ) {
+      const std::vector< Flash >& pass1 = fChannels[ch].pass1;
+      for ( std::size_t i=0; i<pass1.size(); i++ ) {
+	if ( pass1[i].maxamp<fMinSeedAmp ) continue;
+	seeds.push_back( Seed{ pass1[i].maxamp, (int)ch, pass1[i].tstart, (int)i } );
+      }
+    }
+    std::sort( seeds.begin(), seeds.end(), []( const Seed& a, const Seed& b ) {
+	if ( a.amp!=b.amp ) return a.amp>b.amp;
+	if ( a.ch!=b.ch ) return a.ch<b.ch;
+	return a.tstart<b.tstart;
+      } );
+
+    int nadded = 0;
+    for ( auto const& seed : seeds ) {
+      if ( isClaimed( fChannels[seed.ch].claimed1, seed.index ) ) continue;
+
+      const Flash& seedflash = fChannels[seed.ch].pass1[seed.index];
+      int t0 = seed.tstart - fPreWindow;
+      int t1 = seed.tstart + std::max( fPostWindow, 1 ); // always covers the seed itself
+
+      SubEvent subevent;
+      subevent.runid = fRun;
+      subevent.subrunid = fSubRun;
+      subevent.eventid = fEvent;
+      subevent.tstart_sample = seed.tstart;
+      subevent.tmax_sample = seedflash.tmax;
+      subevent.maxamp = seedflash.maxamp;
+      subevent.tend_sample = seed.tstart;
+
+      for ( auto& slot : fChannels ) {
+	int tend1 = claimWindow( slot.pass1, slot.claimed1, t0, t1, subevent.flashes );
+	int tend2 = claimWindow( slot.pass2, slot.claimed2, t0, t1, subevent.flashes_pass2 );
+	subevent.tend_sample = std::max( subevent.tend_sample, std::max( tend1, tend2 ) );
+      }
+
+      subevent.totpe_1 = subevent.pe30_1 = 0.0;
+      for ( FlashListIter it=subevent.flashes.begin(); it!=subevent.flashes.end(); it++ ) {
+	subevent.tstart_sample = std::min( subevent.tstart_sample, it->tstart );
+	subevent.totpe_1 += it->area;
+	subevent.pe30_1 += it->area30;
+	subevent.sumfcomp_gausintegral += it->fcomp_gausintegral;
+      }
+      subevent.totpe = subevent.totpe_1;
+      subevent.pe30 = subevent.pe30_1;
+      for ( FlashListIter it=subevent.flashes_pass2.begin(); it!=subevent.flashes_pass2.end(); it++ ) {
+	subevent.tstart_sample = std::min( subevent.tstart_sample, it->tstart );
+	subevent.totpe += it->area;
+	subevent.pe30 += it->area30;
+	subevent.sumfcomp_gausintegral += it->fcomp_gausintegral;
+      }
+      subevent.sumflash30 = subevent.pe30;
+
+      subevent.tstart_ns = subevent.tstart_sample*fNsPerSample;
+      subevent.tend_ns = subevent.tend_sample*fNsPerSample;
+      subevent.tmax_ns = subevent.tmax_sample*fNsPerSample;
+
+      subevents.add( std::move( subevent ) );
+      nadded++;
+    }
+
+    fUnclaimed1 = fUnclaimed2 = 0;
+    for ( auto const& slot : fChannels ) {
+      fUnclaimed1 += countUnclaimed( slot.pass1, slot.claimed1 );
+      fUnclaimed2 += countUnclaimed( slot.pass2, slot.claimed2 );
+    }
+
+    return nadded;
+  }
+
+}
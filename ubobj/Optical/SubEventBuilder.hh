@@ -0,0 +1,96 @@
+#ifndef __SUBEVENTBUILDER__
+#define __SUBEVENTBUILDER__
+
+#include "Flash.hh"
+#include "FlashList.hh"
+#include "SubEvent.hh"
+#include "SubEventList.hh"
+#include <cstdint>
+#include <vector>
+
+// Two-pass subevent builder fed by per-channel flash finding.
+//
+// Usage: one task per PMT channel calls setChannel( ch, pass1, pass2 ) with
+// the flashes it found. Every channel owns its own slot, so concurrent calls
+// for different channels need no locking; each channel must be set by one
+// task only. Once all tasks are joined, build() merges the channels into
+// SubEvents.
+//
+// The merge is deterministic: pass-1 flashes seed subevents in order of
+// decreasing maxamp (ties broken by channel, then time), and each seed claims
+// every unclaimed flash, on any channel, whose tstart falls in
+// [seed.tstart - preWindow, seed.tstart + postWindow). Claims are tracked in
+// per-channel bitsets owned by the builder rather than in Flash::claimed, so
+// input flashes are never shared mutable state. Flashes handed to a subevent
+// are moved out of the builder and marked claimed on the way.
+//
+// Flashes that no seed window reaches (pass-2 flashes away from every pass-1
+// seed, and pass-1 flashes below the seed threshold) are not put in any
+// subevent; build() counts them in getNumberOfUnclaimed().
+
+namespace subevent {
+
+  class SubEventBuilder {
+
+  public:
+    SubEventBuilder( int nchannels, int preWindow, int postWindow, double nsPerSample );
+
+    // thread-safe for distinct channels
+    void setChannel( int ch, FlashList&& pass1, FlashList&& pass2 );
+
+    void setEventIDs( int run, int subrun, int event ) { fRun = run; fSubRun = subrun; fEvent = event; };
+    void setMinSeedAmp( double amp ) { fMinSeedAmp = amp; };
+
+    // merge all channels; appends to subevents and returns the number added.
+    // The claimed flashes are moved out, so call build() once per setChannel() round.
+    int build( SubEventList& subevents );
+
+    // flashes of the last build() that ended up in no subevent, per pass
+    int getNumberOfUnclaimed( int pass ) const { return pass==1 ? fUnclaimed1 : fUnclaimed2; };
+
+    // drops all channel input so the builder can be reused for the next event
+    void reset();
+
+    int nchannels() const { return fChannels.size(); };
+
+  protected:
+
+    // one slot per channel; flashes are kept sorted by tstart
+    struct ChannelSlot {
+      std::vector< Flash > pass1;
+      std::vector< Flash > pass2;
+      std::vector< uint64_t > claimed1;
+      std::vector< uint64_t > claimed2;
+    };
+
+    struct Seed {
+      double amp;
+      int ch;
+      int tstart;
+      int index;
+    };
+
+    static void sortByStart( std::vector< Flash >& flashes );
+    static bool isClaimed( const std::vector< uint64_t >& bits, std::size_t i ) { return (bits[i>>6]>>(i&63))&1; };
+    static void claim( std::vector< uint64_t >& bits, std::size_t i ) { bits[i>>6] |= (uint64_t(1)<<(i&63)); };
+
+    // claims every unclaimed flash with tstart in [t0,t1) into out; returns the latest tend
+    static int claimWindow( std::vector< Flash >& flashes, std::vector< uint64_t >& bits, int t0, int t1, FlashList& out );
+    static int countUnclaimed( const std::vector< Flash >& flashes, const std::vector< uint64_t >& bits );
+
+    std::vector< ChannelSlot > fChannels;
+    int fPreWindow;
+    int fPostWindow;
+    double fNsPerSample;
+    double fMinSeedAmp;
+    int fRun;
+    int fSubRun;
+    int fEvent;
+    int fUnclaimed1;
+    int fUnclaimed2;
+
+  };
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "SubEventList.hh"
 #include <algorithm>
+#include <utility>
 
 #ifdef __BUILD_ROOT_DICT__
 ClassImp( subevent::SubEventList )
@@ -7,13 +8,16 @@ ClassImp( subevent::SubEventList )
 
 namespace subevent {
 
-  SubEventList::SubEventList() {
+  SubEventList::SubEventList() :
+    sortMethod( kUnsorted )
+  {
     fSubEvents.reserve(10);
   }
   SubEventList::~SubEventList() {}
 
   int SubEventList::add( SubEvent&& opflash ) {
-    fSubEvents.emplace_back( opflash );
+    fSubEvents.emplace_back( std::move( opflash ) );
+    sortMethod = kUnsorted;
     return fSubEvents.size();
   }
 
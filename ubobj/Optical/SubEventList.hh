@@ -34,7 +34,7 @@ namespace subevent {
     void sortByCharge();
     void sortByAmp();
     int size() { return fSubEvents.size(); };
-    void clear() { fSubEvents.clear(); fSubEvents.reserve(20); };
+    void clear() { fSubEvents.clear(); fSubEvents.reserve(20); sortMethod = kUnsorted; };
     bool sortedByTime() { if (sortMethod==kByTime) return true; else return false; }; 
     bool sortedByCharge() { if (sortMethod==kByCharge) return true; else return false; }; 
     bool sortedByAmp() { if (sortMethod==kByAmp) return true; else return false; }; 
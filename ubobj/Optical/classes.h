@@ -14,6 +14,7 @@
 #include "ubobj/Optical/Flash.hh"
 #include "ubobj/Optical/SubEventList.hh"
 #include "ubobj/Optical/FlashList.hh"
+#include "ubobj/Optical/FlatSubEventList.hh"
 
 
 //
@@ -0,0 +1,84 @@
+/**
+ * \file FlashIntegrals_test.cc
+ *
+ * \brief Unit test of the Flash integral kernels: partial sums against a
+ * plain loop, the area30 window, the peak search and the Gaussian estimate
+ *
+ */
+
+#define BOOST_TEST_MODULE ( FlashIntegrals_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/Optical/FlashIntegrals.hh"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(sums_match_plain_loop)
+{
+  std::mt19937 rng(2024);
+  std::uniform_real_distribution<double> q(-5., 100.);
+  // lengths around the 4-way unroll, so every remainder is exercised
+  for (std::size_t n : { 0u, 1u, 3u, 4u, 5u, 30u, 31u, 257u }) {
+    std::vector<double> d(n);
+    std::vector<float> f(n);
+    for (std::size_t i = 0; i < n; ++i) f[i] = d[i] = float(q(rng));
+    double plain = 0, plain30 = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      plain += d[i];
+      if (i < subevent::kArea30Window) plain30 += d[i];
+    }
+    BOOST_TEST(subevent::sampleSum(d.data(), n) == plain, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(subevent::sampleSum(f.data(), n) == plain, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(subevent::windowSum(d.data(), n, 0, subevent::kArea30Window) == plain30, boost::test_tools::tolerance(1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(window_is_clipped)
+{
+  std::vector<float> wf{ 1, 2, 3, 4, 5 };
+  BOOST_TEST(subevent::windowSum(wf.data(), wf.size(), 3, 10) == 9.);
+  BOOST_TEST(subevent::windowSum(wf.data(), wf.size(), 5, 10) == 0.);
+  BOOST_TEST(subevent::windowSum(wf.data(), wf.size(), 1, 2) == 5.);
+}
+
+BOOST_AUTO_TEST_CASE(peak_is_first_maximum)
+{
+  std::vector<float> wf{ 0, 3, 7, 7, 1 };
+  subevent::FlashPeak peak = subevent::findPeak(wf.data(), wf.size());
+  BOOST_TEST(peak.index == 2);
+  BOOST_TEST(peak.amp == 7.);
+  BOOST_TEST(subevent::findPeak(wf.data(), 0).index == -1);
+}
+
+BOOST_AUTO_TEST_CASE(gaussian_integral_of_a_gaussian)
+{
+  // a sampled Gaussian returns its own area A*sigma*sqrt(2pi)
+  const double amp = 50, mean = 40, sigma = 6;
+  std::vector<double> wf(100);
+  for (std::size_t i = 0; i < wf.size(); ++i) wf[i] = amp * std::exp(-0.5 * std::pow((i - mean) / sigma, 2));
+  const double expected = amp * sigma * std::sqrt(2 * M_PI);
+  BOOST_TEST(subevent::gaussianIntegral(wf.data(), wf.size(), amp) == expected, boost::test_tools::tolerance(1e-3));
+
+  // negative samples are ignored; a flat or empty pulse has no width
+  std::vector<double> flat{ -1, 0, 0, -2 };
+  BOOST_TEST(subevent::gaussianIntegral(flat.data(), flat.size(), 1.) == 0.);
+}
+
+BOOST_AUTO_TEST_CASE(fill_integrals_of_a_flash)
+{
+  subevent::Flash flash;
+  flash.tstart = 100;
+  flash.tmax = -1;
+  flash.maxamp = 0;
+  std::vector<float> wf(40, 1.f);
+  wf[12] = 9.f;
+  flash.storeWaveform(wf);
+  subevent::fillIntegrals(flash);
+  BOOST_TEST(flash.area == 48.f);
+  BOOST_TEST(flash.area30 == 38.f);
+  BOOST_TEST(flash.tmax == 112);
+  BOOST_TEST(flash.maxamp == 9.f);
+}
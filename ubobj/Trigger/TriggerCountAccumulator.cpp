@@ -0,0 +1,154 @@
+
+#include <cmath>
+#include "TriggerCountAccumulator.h"
+
+//-----------------------------------------------------------------------------------
+
+void raw::KahanSum::add(double x){
+  double t = sum + x;
+  // keep the low-order bits of whichever operand was smaller
+  if (std::fabs(sum) >= std::fabs(x)) compensation += (sum - t) + x;
+  else compensation += (x - t) + sum;
+  sum = t;
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::KahanSum::merge(const KahanSum& other){
+  add(other.sum);
+  add(other.compensation);
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::Counts::merge(const Counts& other){
+  nPresent += other.nPresent;
+  nPassed += other.nPassed;
+  nPassedPrescale += other.nPassedPrescale;
+  nPassedBoth += other.nPassedBoth;
+  weighted.merge(other.weighted);
+  weighted2.merge(other.weighted2);
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerCountAccumulator::TriggerCountAccumulator() : nEvents(0), nUnresolved(0) {
+
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerCountAccumulator::MenuSlots* raw::TriggerCountAccumulator::findMenu(uint64_t content) const{
+  for (auto const& m: menuCache.fMenus){
+    if (m.content == content) return &m;
+  }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerCountAccumulator::MenuSlots& raw::TriggerCountAccumulator::menuSlots(uint64_t content, const ubdaqSoftwareTriggerMenu& menu){
+  // menus with the same names but new prescales get their own entry
+  if (const MenuSlots* m = findMenu(content)) return *m;
+
+  MenuSlots m;
+  m.content = content;
+  for (int i(0); i < menu.getNumberOfAlgorithms(); ++i){
+    m.slots.push_back(&counts[menu.getAlgorithmName(i)]); // map nodes do not move
+    m.weights.push_back(menu.getPrescale(i));
+  }
+  menuCache.fMenus.push_back(std::move(m));
+  return menuCache.fMenus.back();
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::fill(const ubdaqSoftwareTriggerData& event){
+  ++nEvents;
+  if (event.hasMenu()){
+    count(event, menuSlots(event.getContentHash(), event.getMenu()));
+    return;
+  }
+  // detached event: only a menu with exactly this content will do
+  const MenuSlots* m = findMenu(event.getContentHash());
+  if (!m){
+    ++nUnresolved;
+    return;
+  }
+  count(event, *m);
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::fill(const ubdaqSoftwareTriggerView& event){
+  ++nEvents;
+  count(event.data(), menuSlots(event.data().getContentHash(), event.menu()));
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::count(const ubdaqSoftwareTriggerData& event, const MenuSlots& m){
+  for (unsigned int i(0); i < m.slots.size(); ++i){
+    Counts& c = *m.slots[i];
+    bool pass = event.tryPass(i).value_or(false);
+    bool prescale = event.tryPassPrescale(i).value_or(false);
+    ++c.nPresent;
+    c.nPassed += pass;
+    c.nPassedPrescale += prescale;
+    if (pass && prescale){
+      double w = m.weights[i];
+      ++c.nPassedBoth;
+      c.weighted.add(w);
+      c.weighted2.add(w*w);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::merge(const TriggerCountAccumulator& other){
+  nEvents += other.nEvents;
+  nUnresolved += other.nUnresolved;
+  for (auto const& entry: other.counts){
+    counts[entry.first].merge(entry.second); // inserting never invalidates the menu cache
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerCountAccumulator::clear(){
+  nEvents = 0;
+  nUnresolved = 0;
+  counts.clear();
+  menuCache.fMenus.clear();
+}
+
+//-----------------------------------------------------------------------------------
+
+std::vector<std::string> raw::TriggerCountAccumulator::getListOfAlgorithms() const{
+  std::vector<std::string> list;
+  for (auto const& entry: counts){
+    list.push_back(entry.first);
+  }
+  return list;
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerCountAccumulator::Counts& raw::TriggerCountAccumulator::getCounts(std::string_view algo) const{
+  static const Counts empty;
+  auto it = counts.find(std::string(algo));
+  return it == counts.end() ? empty : it->second;
+}
+
+//-----------------------------------------------------------------------------------
+
+double raw::TriggerCountAccumulator::getWeightedCount(std::string_view algo) const{
+  return getCounts(algo).weighted.value();
+}
+
+//-----------------------------------------------------------------------------------
+
+double raw::TriggerCountAccumulator::getWeightedCountError(std::string_view algo) const{
+  return std::sqrt(getCounts(algo).weighted2.value());
+}
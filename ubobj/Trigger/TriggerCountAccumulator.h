@@ -0,0 +1,97 @@
+#ifndef _UBOONETYPES_TRIGGERCOUNTACCUMULATOR_H
+#define _UBOONETYPES_TRIGGERCOUNTACCUMULATOR_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ubobj/Trigger/ubdaqSoftwareTriggerData.h"
+
+namespace raw{
+
+// Compensated (Kahan-Babuska/Neumaier) running sum; two partial sums merge
+// without losing their compensation terms.
+struct KahanSum {
+  double sum = 0;
+  double compensation = 0;
+
+  void add(double x);
+  void merge(const KahanSum& other);
+  double value() const { return sum + compensation; }
+};
+
+// Per-algorithm software trigger counts, filled once per event and mergeable
+// across threads (one accumulator per thread, merged at the end) and jobs (it
+// has a dictionary, so it can be stored as a Run/SubRun product and combined
+// through aggregate()).
+//
+// Algorithms are keyed by name, so accumulators filled with different menus
+// merge correctly. Prescale-weighted totals sum prescale_weight over events
+// that passed both the algorithm and its prescale: each such event stands
+// for prescale_weight events before prescaling. A detached event is counted
+// with the menu of the same content hash (names and prescale weights) seen
+// earlier in this accumulator, and as unresolved if there is none.
+class TriggerCountAccumulator {
+
+ public:
+  struct Counts {
+    uint64_t nPresent = 0; // events whose menu has the algorithm
+    uint64_t nPassed = 0;
+    uint64_t nPassedPrescale = 0;
+    uint64_t nPassedBoth = 0;
+    KahanSum weighted; // sum of prescale_weight over nPassedBoth events
+    KahanSum weighted2; // sum of prescale_weight^2, for the uncertainty on weighted
+
+    void merge(const Counts& other);
+  };
+
+  TriggerCountAccumulator();
+
+  void fill(const ubdaqSoftwareTriggerData& event);
+  void fill(const ubdaqSoftwareTriggerView& event); // a detached event with its run's menu
+  void merge(const TriggerCountAccumulator& other);
+  void aggregate(const TriggerCountAccumulator& other) { merge(other); } // art Run/SubRun product combination
+  void clear();
+
+  uint64_t getNumberOfEvents() const { return nEvents; }
+  uint64_t getNumberOfUnresolvedEvents() const { return nUnresolved; } // detached events whose content hash was not seen
+  std::vector<std::string> getListOfAlgorithms() const;
+  const Counts& getCounts(std::string_view algo) const; // all zero if the algorithm was never seen
+
+  double getWeightedCount(std::string_view algo) const;
+  double getWeightedCountError(std::string_view algo) const; // sqrt of the sum of squared weights
+
+ private:
+
+  // counts of each algorithm of one menu, in menu order, and the menu's prescale weights
+  struct MenuSlots {
+    uint64_t content; // ubdaqSoftwareTriggerMenu::getContentHash()
+    std::vector<Counts*> slots;
+    std::vector<float> weights;
+  };
+
+  // Points into counts, so copies start empty.
+  class MenuCache {
+   public:
+    MenuCache() {}
+    MenuCache(const MenuCache&) {}
+    MenuCache& operator=(const MenuCache&) { fMenus.clear(); return *this; }
+    std::vector<MenuSlots> fMenus;
+  };
+
+  const MenuSlots* findMenu(uint64_t content) const;
+  const MenuSlots& menuSlots(uint64_t content, const ubdaqSoftwareTriggerMenu& menu);
+  void count(const ubdaqSoftwareTriggerData& event, const MenuSlots& m);
+
+  uint64_t nEvents;
+  uint64_t nUnresolved;
+  std::map<std::string, Counts> counts;
+
+  MenuCache menuCache; //! transient
+
+};
+
+}  // end of namespace raw
+
+#endif
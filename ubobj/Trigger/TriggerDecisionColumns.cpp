@@ -0,0 +1,195 @@
+
+#include <algorithm>
+#include "TriggerDecisionColumns.h"
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerDecisionColumns::TriggerDecisionColumns(const std::vector<std::string>& algos)
+  : fAlgos(algos), fColumns(algos.size()), fNEvents(0), fNSkipped(0) {
+
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerDecisionColumns::MenuMap* raw::TriggerDecisionColumns::findMenu(uint64_t content) const{
+  for (auto const& m: fMenus){
+    if (m.content == content) return &m;
+  }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerDecisionColumns::MenuMap& raw::TriggerDecisionColumns::menuMap(uint64_t content, const ubdaqSoftwareTriggerMenu& names){
+  if (const MenuMap* m = findMenu(content)) return *m;
+
+  MenuMap m;
+  m.content = content;
+  for (auto const& algo: fAlgos){
+    int id = names.find(algo);
+    m.index.push_back(id);
+    m.weight.push_back(names.getPrescale(id));
+  }
+  fMenus.push_back(std::move(m));
+  return fMenus.back();
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerDecisionColumns::add(const ubdaqSoftwareTriggerData& event){
+  if (event.hasMenu()){
+    append(event, menuMap(event.getContentHash(), event.getMenu()));
+    return true;
+  }
+  // a detached event needs its menu to have been seen already
+  const MenuMap* m = findMenu(event.getContentHash());
+  if (!m){
+    ++fNSkipped;
+    return false;
+  }
+  append(event, *m);
+  return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerDecisionColumns::add(const ubdaqSoftwareTriggerView& event){
+  append(event.data(), menuMap(event.data().getContentHash(), event.menu()));
+  return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerDecisionColumns::append(const ubdaqSoftwareTriggerData& event, const MenuMap& m){
+  std::size_t word = fNEvents/64;
+  uint64_t bit = uint64_t(1) << (fNEvents%64);
+
+  for (unsigned int a(0); a < fColumns.size(); ++a){
+    Column& c = fColumns[a];
+    if (bit == 1){
+      c.present.push_back(0);
+      c.pass.push_back(0);
+      c.prescale.push_back(0);
+    }
+    int id = m.index[a];
+    if (id < 0){
+      c.phmax.push_back(0);
+      c.multiplicity.push_back(0);
+      c.triggerTick.push_back(0);
+      c.weight.push_back(0);
+      continue;
+    }
+    c.present[word] |= bit;
+    if (event.getPass(id)) c.pass[word] |= bit;
+    if (event.getPassPrescale(id)) c.prescale[word] |= bit;
+    c.phmax.push_back(event.getPhmax(id));
+    c.multiplicity.push_back(event.getMultiplicity(id));
+    c.triggerTick.push_back(event.getTriggerTick(id));
+    c.weight.push_back(m.weight[a]);
+  }
+  ++fNEvents;
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerDecisionColumns::add(const std::vector<ubdaqSoftwareTriggerData>& events){
+  for (auto const& event: events){
+    add(event);
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerDecisionColumns::add(const std::vector<const ubdaqSoftwareTriggerData*>& events){
+  for (auto const* event: events){
+    add(*event);
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerDecisionColumns::clear(){
+  fColumns.assign(fAlgos.size(), Column());
+  fNEvents = 0;
+  fNSkipped = 0;
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::TriggerDecisionColumns::getID(std::string_view algo) const{
+  auto it = std::find(fAlgos.begin(), fAlgos.end(), algo);
+  return it == fAlgos.end() ? -1 : int(it - fAlgos.begin());
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::popcount(const std::vector<uint64_t>& bits){
+  uint64_t n = 0;
+  for (uint64_t w: bits){
+    n += __builtin_popcountll(w);
+  }
+  return n;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::popcountAnd(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b){
+  uint64_t n = 0;
+  std::size_t size = std::min(a.size(), b.size());
+  for (std::size_t i(0); i < size; ++i){
+    n += __builtin_popcountll(a[i] & b[i]);
+  }
+  return n;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::countPresent(int a) const{
+  return popcount(fColumns[a].present);
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::countPassed(int a) const{
+  return popcount(fColumns[a].pass);
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::countPassedPrescale(int a) const{
+  return popcount(fColumns[a].prescale);
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::countPassedBoth(int a) const{
+  return popcountAnd(fColumns[a].pass, fColumns[a].prescale);
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerDecisionColumns::countPassed(int a, int given) const{
+  return popcountAnd(fColumns[a].pass, fColumns[given].pass);
+}
+
+//-----------------------------------------------------------------------------------
+
+double raw::TriggerDecisionColumns::efficiency(int a, int given) const{
+  uint64_t denominator = countPassed(given);
+  if (denominator == 0) return 0;
+  return double(countPassed(a, given))/denominator;
+}
+
+//-----------------------------------------------------------------------------------
+
+double raw::TriggerDecisionColumns::weightedCount(int a) const{
+  const Column& c = fColumns[a];
+  double sum = 0;
+  for (std::size_t w(0); w < c.pass.size(); ++w){
+    // visit only the set bits of each word
+    for (uint64_t bits = c.pass[w] & c.prescale[w]; bits; bits &= bits - 1){
+      sum += c.weight[w*64 + __builtin_ctzll(bits)];
+    }
+  }
+  return sum;
+}
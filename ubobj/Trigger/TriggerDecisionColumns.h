@@ -0,0 +1,92 @@
+#ifndef _UBOONETYPES_TRIGGERDECISIONCOLUMNS_H
+#define _UBOONETYPES_TRIGGERDECISIONCOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ubobj/Trigger/ubdaqSoftwareTriggerData.h"
+
+namespace raw{
+
+// Columnar view of the software trigger decisions of many events.
+//
+// The algorithms of interest are fixed at construction. add() appends one
+// event; for each algorithm the decisions go into bit columns (event n in
+// bit n%64 of word n/64) and the numeric values into plain arrays, so
+// run-level studies reduce to popcounts and linear passes instead of one
+// accessor call per event and algorithm. Names are resolved once per menu
+// (by content hash, so menus that differ only in prescale weights are kept
+// apart), so events from the same run cost no name lookups.
+// An algorithm missing from an event's menu has its present bit clear and
+// zeros elsewhere. A detached event whose content hash has not been seen,
+// through an embedded menu or a view, cannot be resolved: add() skips it,
+// returns false and counts it in getNumberOfSkipped().
+class TriggerDecisionColumns {
+
+ public:
+  TriggerDecisionColumns(const std::vector<std::string>& algos);
+
+  bool add(const ubdaqSoftwareTriggerData& event); // false if skipped
+  bool add(const ubdaqSoftwareTriggerView& event); // a detached event with its run's menu
+  void add(const std::vector<ubdaqSoftwareTriggerData>& events);
+  void add(const std::vector<const ubdaqSoftwareTriggerData*>& events);
+  void clear(); // drop the events, keep the algorithms
+
+  std::size_t getNumberOfEvents() const { return fNEvents; }
+  std::size_t getNumberOfSkipped() const { return fNSkipped; } // events add() could not resolve
+  int getNumberOfAlgorithms() const { return fAlgos.size(); }
+  const std::vector<std::string>& getListOfAlgorithms() const { return fAlgos; }
+  int getID(std::string_view algo) const; // column index, -1 if not one of the algorithms
+
+  // columns, index-aligned with the events added (skipped events have no entry)
+  const std::vector<uint64_t>& getPresentColumn(int a) const { return fColumns[a].present; }
+  const std::vector<uint64_t>& getPassColumn(int a) const { return fColumns[a].pass; }
+  const std::vector<uint64_t>& getPrescaleColumn(int a) const { return fColumns[a].prescale; }
+  const std::vector<uint32_t>& getPhmaxColumn(int a) const { return fColumns[a].phmax; }
+  const std::vector<uint32_t>& getMultiplicityColumn(int a) const { return fColumns[a].multiplicity; }
+  const std::vector<uint32_t>& getTriggerTickColumn(int a) const { return fColumns[a].triggerTick; }
+  const std::vector<float>& getPrescaleWeightColumn(int a) const { return fColumns[a].weight; }
+
+  // reductions
+  uint64_t countPresent(int a) const;
+  uint64_t countPassed(int a) const;
+  uint64_t countPassedPrescale(int a) const;
+  uint64_t countPassedBoth(int a) const; // passed the algorithm and its prescale
+  uint64_t countPassed(int a, int given) const; // passed a among events that passed given
+  double efficiency(int a, int given) const; // countPassed(a, given)/countPassed(given), 0 if none passed given
+  double weightedCount(int a) const; // prescale weights summed over events that passed the algorithm and its prescale
+
+  static uint64_t popcount(const std::vector<uint64_t>& bits);
+  static uint64_t popcountAnd(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b);
+
+ private:
+  struct Column {
+    std::vector<uint64_t> present, pass, prescale;
+    std::vector<uint32_t> phmax, multiplicity, triggerTick;
+    std::vector<float> weight;
+  };
+
+  // menu indices of fAlgos (-1 if absent) and their prescale weights, for one menu
+  struct MenuMap {
+    uint64_t content; // ubdaqSoftwareTriggerMenu::getContentHash()
+    std::vector<int> index;
+    std::vector<float> weight;
+  };
+
+  const MenuMap* findMenu(uint64_t content) const;
+  const MenuMap& menuMap(uint64_t content, const ubdaqSoftwareTriggerMenu& names);
+  void append(const ubdaqSoftwareTriggerData& event, const MenuMap& m);
+
+  std::vector<std::string> fAlgos;
+  std::vector<Column> fColumns;
+  std::vector<MenuMap> fMenus; // one per menu seen, usually one per run
+  std::size_t fNEvents;
+  std::size_t fNSkipped;
+
+};
+
+}  // end of namespace raw
+
+#endif
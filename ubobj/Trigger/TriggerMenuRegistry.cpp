@@ -0,0 +1,117 @@
+
+#include <iterator>
+#include <stdexcept>
+#include "TriggerMenuRegistry.h"
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerMenuRegistry& raw::TriggerMenuRegistry::instance(){
+  static TriggerMenuRegistry registry;
+  return registry;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerMenuRegistry::sameContent(const ubdaqSoftwareTriggerMenu& a, const ubdaqSoftwareTriggerMenu& b){
+  if (a.getListOfAlgorithms() != b.getListOfAlgorithms()) return false;
+  for (int i(0); i < a.getNumberOfAlgorithms(); ++i){
+    if (a.getPrescale(i) != b.getPrescale(i)) return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerMenuRegistry::MenuID raw::TriggerMenuRegistry::intern(const ubdaqSoftwareTriggerMenu& menu){
+  uint64_t hash = menu.getContentHash();
+  {
+    std::shared_lock<std::shared_mutex> lock(fMutex);
+    auto range = fByContent.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it){
+      if (sameContent(fEntries[it->second]->menu, menu)) return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(fMutex);
+  // another thread may have added it while we were unlocked
+  auto range = fByContent.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it){
+    if (sameContent(fEntries[it->second]->menu, menu)) return it->second;
+  }
+  MenuID id = fEntries.size();
+  auto e = std::make_unique<Entry>();
+  e->menu = menu;
+  e->contentHash = hash;
+  fEntries.push_back(std::move(e));
+  fByContent.emplace(hash, id);
+  return id;
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerMenuRegistry::MenuID raw::TriggerMenuRegistry::lookup(const ubdaqSoftwareTriggerData& event){
+  if (event.hasMenu()) return intern(event.getMenu());
+
+  // only the hash is left to go on, so it has to name exactly one menu
+  std::shared_lock<std::shared_mutex> lock(fMutex);
+  auto range = fByContent.equal_range(event.getContentHash());
+  if (range.first == range.second || std::next(range.first) != range.second){
+    fMisses.fetch_add(1, std::memory_order_relaxed);
+    return kInvalidMenu;
+  }
+  return range.first->second;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerMenuRegistry::getMisses() const{
+  return fMisses.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerMenuRegistry::Entry& raw::TriggerMenuRegistry::entry(MenuID id) const{
+  std::shared_lock<std::shared_mutex> lock(fMutex);
+  if (id >= fEntries.size()){
+    throw std::out_of_range("TriggerMenuRegistry: unknown menu ID " + std::to_string(id));
+  }
+  return *fEntries[id]; // entries are never removed, so the reference outlives the lock
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::ubdaqSoftwareTriggerMenu& raw::TriggerMenuRegistry::getMenu(MenuID id) const{
+  return entry(id).menu;
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerSelection& raw::TriggerMenuRegistry::getSelection(MenuID id, std::string_view expression){
+  Entry& e = entry(id);
+  std::lock_guard<std::mutex> lock(e.selectionMutex);
+  auto it = e.selections.find(expression);
+  if (it != e.selections.end()) return *it->second;
+
+  auto selection = std::make_unique<TriggerSelection>(expression, e.menu.getListOfAlgorithms());
+  return *e.selections.emplace(std::string(expression), std::move(selection)).first->second;
+}
+
+//-----------------------------------------------------------------------------------
+
+std::size_t raw::TriggerMenuRegistry::size() const{
+  std::shared_lock<std::shared_mutex> lock(fMutex);
+  return fEntries.size();
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerMenuRegistry::Tracker::update(const ubdaqSoftwareTriggerData& event){
+  uint64_t hash = event.getContentHash();
+  if (fID != kInvalidMenu && hash == fHash) return false;
+
+  MenuID id = fRegistry.lookup(event);
+  bool changed = id != fID;
+  fHash = hash;
+  fID = id;
+  return changed;
+}
@@ -0,0 +1,83 @@
+#ifndef _UBOONETYPES_TRIGGERMENUREGISTRY_H
+#define _UBOONETYPES_TRIGGERMENUREGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ubobj/Trigger/TriggerSelection.h"
+#include "ubobj/Trigger/ubdaqSoftwareTriggerData.h"
+#include "ubobj/Trigger/ubdaqSoftwareTriggerMenu.h"
+
+namespace raw{
+
+// Registry of the software trigger menus seen in a job, interned by content
+// (names and prescale weights). Each distinct menu gets a small integer ID
+// that stays valid for the lifetime of the registry, together with state
+// that is worth keeping per menu: the menu's name -> index table and every
+// TriggerSelection compiled against it.
+//
+// Menus only change at run boundaries, so a consumer keeps a
+// TriggerMenuRegistry::Tracker and asks it once per event whether the menu
+// changed; that costs a content-hash compare.
+//
+// All members are safe to call from several threads. instance() gives a
+// process-wide registry; separate registries can also be created.
+class TriggerMenuRegistry {
+
+ public:
+  typedef uint32_t MenuID;
+  static constexpr MenuID kInvalidMenu = MenuID(-1);
+
+  TriggerMenuRegistry() : fMisses(0) {}
+  static TriggerMenuRegistry& instance();
+
+  MenuID intern(const ubdaqSoftwareTriggerMenu& menu);
+  // the event's menu; a detached event is resolved by its content hash alone,
+  // and gives kInvalidMenu (counted in getMisses()) unless that menu was interned
+  MenuID lookup(const ubdaqSoftwareTriggerData& event);
+  uint64_t getMisses() const; // lookups of detached events that found no menu
+
+  const ubdaqSoftwareTriggerMenu& getMenu(MenuID id) const;
+  // compiled once per menu and expression; throws std::invalid_argument like TriggerSelection
+  const TriggerSelection& getSelection(MenuID id, std::string_view expression);
+  std::size_t size() const;
+
+  // per-consumer "did the menu change?" check
+  class Tracker {
+  public:
+    Tracker(TriggerMenuRegistry& registry=instance()) : fRegistry(registry), fHash(0), fID(kInvalidMenu) {}
+    bool update(const ubdaqSoftwareTriggerData& event); // true when the event's menu differs from the previous event's
+    MenuID current() const { return fID; }
+  private:
+    TriggerMenuRegistry& fRegistry;
+    uint64_t fHash; // content hash of the current menu
+    MenuID fID;
+  };
+
+ private:
+  struct Entry {
+    ubdaqSoftwareTriggerMenu menu;
+    uint64_t contentHash;
+    std::mutex selectionMutex;
+    std::map<std::string, std::unique_ptr<TriggerSelection>, std::less<> > selections;
+  };
+
+  static bool sameContent(const ubdaqSoftwareTriggerMenu& a, const ubdaqSoftwareTriggerMenu& b);
+  Entry& entry(MenuID id) const;
+
+  mutable std::shared_mutex fMutex;
+  std::vector<std::unique_ptr<Entry> > fEntries; // indexed by MenuID, never shrinks
+  std::multimap<uint64_t, MenuID> fByContent;
+  std::atomic<uint64_t> fMisses;
+
+};
+
+}  // end of namespace raw
+
+#endif
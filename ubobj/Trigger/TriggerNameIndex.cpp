@@ -0,0 +1,77 @@
+
+#include "TriggerNameIndex.h"
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerNameTable::hash(std::string_view s){
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c: s){
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerNameTable::combine(uint64_t menu, std::string_view name){
+  return (menu ^ hash(name)) * 1099511628211ULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::TriggerNameTable::menuHash(const std::vector<std::string>& names){
+  uint64_t menu = hash("");
+  for (auto const& name: names){
+    menu = combine(menu, name);
+  }
+  return menu;
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerNameTable::TriggerNameTable(const std::vector<std::string>& names, const TriggerNameTable* retired)
+  : fSize(names.size()), fRetired(retired) {
+  // keep the load factor at or below 1/2 so probe chains stay short
+  std::size_t size = 8;
+  while (size < 2*names.size()) size *= 2;
+  fSlots.assign(size, Slot{0, -1});
+  fMask = size - 1;
+
+  fMenuHash = hash("");
+  for (unsigned int i(0); i < names.size(); ++i){
+    uint64_t h = hash(names[i]);
+    fMenuHash = combine(fMenuHash, names[i]);
+
+    // first occurrence wins, matching the old linear scan in getID
+    if (find(names[i], names) >= 0) continue;
+    uint64_t pos = h & fMask;
+    while (fSlots[pos].index >= 0) pos = (pos + 1) & fMask;
+    fSlots[pos] = Slot{h, (int)i};
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::TriggerNameTable::find(std::string_view algo, const std::vector<std::string>& names) const{
+  uint64_t h = hash(algo);
+  for (uint64_t pos = h & fMask; fSlots[pos].index >= 0; pos = (pos + 1) & fMask){
+    const Slot& slot = fSlots[pos];
+    if (slot.hash == h && names[slot.index] == algo) return slot.index;
+  }
+  return -1;
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::TriggerNameTable& raw::TriggerNameIndex::get(const std::vector<std::string>& names, uint64_t menuHash) const{
+  const TriggerNameTable* table = fTable.load(std::memory_order_acquire);
+  while (!table || !table->indexes(names, menuHash)){
+    // first use, or the names changed under the table: build one that owns the stale one
+    TriggerNameTable* fresh = new TriggerNameTable(names, table);
+    if (fTable.compare_exchange_strong(table, fresh, std::memory_order_acq_rel)) return *fresh;
+    fresh->fRetired = nullptr; // another thread got there first; table now holds its copy
+    delete fresh;
+  }
+  return *table;
+}
@@ -0,0 +1,78 @@
+#ifndef _UBOONETYPES_TRIGGERNAMEINDEX_H
+#define _UBOONETYPES_TRIGGERNAMEINDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace raw{
+
+// Small open-addressing hash from trigger algorithm name to its index in the
+// algorithm list. Slots hold only the index and the name hash; the name
+// itself is compared against the owner's list, so the table never points
+// into strings that may move. The table records the size and hash of the list
+// it was built from, so an owner can tell when the list changed underneath it.
+class TriggerNameTable {
+
+ public:
+  // retired: a stale table this one replaces, kept alive (and owned) because
+  // other threads may still be reading it
+  TriggerNameTable(const std::vector<std::string>& names, const TriggerNameTable* retired=nullptr);
+  TriggerNameTable(const TriggerNameTable&) = delete;
+  TriggerNameTable& operator=(const TriggerNameTable&) = delete;
+  ~TriggerNameTable() { delete fRetired; }
+
+  // index of algo in names, or -1; names must be the list the table was built from
+  int find(std::string_view algo, const std::vector<std::string>& names) const;
+
+  uint64_t menuHash() const { return fMenuHash; } // hash of the ordered list of names
+  // built from a list of this size and menuHash(); menu is that list's precomputed hash
+  bool indexes(const std::vector<std::string>& names, uint64_t menu) const { return fSize == names.size() && fMenuHash == menu; }
+
+  static uint64_t hash(std::string_view s); // 64-bit FNV-1a
+  static uint64_t menuHash(const std::vector<std::string>& names); // same value menuHash() gives for these names
+  static uint64_t combine(uint64_t menu, std::string_view name); // fold one more name into a menu hash
+
+ private:
+  struct Slot { uint64_t hash; int index; };
+  std::vector<Slot> fSlots; // power-of-two size, index -1 marks an empty slot
+  uint64_t fMask;
+  uint64_t fMenuHash;
+  std::size_t fSize;
+  const TriggerNameTable* fRetired;
+
+  friend class TriggerNameIndex;
+
+};
+
+// Lazily built, copy-resetting holder for a TriggerNameTable.
+// get() builds the table on first use, and rebuilds it when the names no
+// longer match it (ROOT reading into a reused object replaces the names
+// without calling reset()); concurrent callers race with a compare-and-swap
+// and the loser discards its copy, so no lock is taken. A replaced table is
+// freed by the next reset(), since a reader may still hold it.
+// Copies start empty, which keeps the owning data product copyable and lets
+// the member be transient.
+class TriggerNameIndex {
+
+ public:
+  TriggerNameIndex() : fTable(nullptr) {}
+  TriggerNameIndex(const TriggerNameIndex&) : fTable(nullptr) {}
+  TriggerNameIndex& operator=(const TriggerNameIndex&) { reset(); return *this; }
+  ~TriggerNameIndex() { reset(); }
+
+  // names and their TriggerNameTable::menuHash(), which the owner keeps up to date
+  const TriggerNameTable& get(const std::vector<std::string>& names, uint64_t menuHash) const;
+  void reset() { delete fTable.exchange(nullptr); }
+
+ private:
+  mutable std::atomic<const TriggerNameTable*> fTable;
+
+};
+
+}  // end of namespace raw
+
+#endif
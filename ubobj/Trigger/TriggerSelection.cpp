@@ -0,0 +1,262 @@
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include "TriggerSelection.h"
+
+namespace {
+
+  // expression tree, only alive while compiling
+  struct Node {
+    enum Kind { kPass, kPrescale, kNot, kAnd, kOr } kind;
+    int index = -1; // menu index for kPass/kPrescale
+    std::unique_ptr<Node> a, b;
+  };
+
+  class Parser {
+  public:
+    Parser(std::string_view text, const std::vector<std::string>& menu) : fText(text), fPos(0), fMenu(menu) {}
+
+    std::unique_ptr<Node> parse(){
+      auto node = parseOr();
+      skipSpace();
+      if (fPos != fText.size()) fail("unexpected trailing input");
+      return node;
+    }
+
+  private:
+    void fail(const std::string& what) const {
+      throw std::invalid_argument("TriggerSelection: " + what + " at position " + std::to_string(fPos)
+                                  + " in \"" + std::string(fText) + "\"");
+    }
+
+    void skipSpace(){
+      while (fPos < fText.size() && std::isspace((unsigned char)fText[fPos])) ++fPos;
+    }
+
+    static bool isNameChar(char c){ return std::isalnum((unsigned char)c) || c == '_'; }
+
+    std::string_view peekWord(){
+      skipSpace();
+      std::size_t end = fPos;
+      while (end < fText.size() && isNameChar(fText[end])) ++end;
+      return fText.substr(fPos, end - fPos);
+    }
+
+    static bool iequals(std::string_view a, std::string_view b){
+      return a.size() == b.size() &&
+        std::equal(a.begin(), a.end(), b.begin(), [](char x, char y){ return std::toupper((unsigned char)x) == std::toupper((unsigned char)y); });
+    }
+
+    static bool isKeyword(std::string_view w){
+      return iequals(w, "AND") || iequals(w, "OR") || iequals(w, "NOT");
+    }
+
+    bool acceptSymbol(std::string_view sym){
+      skipSpace();
+      if (fText.substr(fPos, sym.size()) == sym){ fPos += sym.size(); return true; }
+      return false;
+    }
+
+    bool acceptKeyword(std::string_view kw){
+      std::string_view w = peekWord();
+      if (iequals(w, kw)){ fPos += w.size(); return true; }
+      return false;
+    }
+
+    static std::unique_ptr<Node> binary(Node::Kind kind, std::unique_ptr<Node> a, std::unique_ptr<Node> b){
+      auto node = std::make_unique<Node>();
+      node->kind = kind;
+      node->a = std::move(a);
+      node->b = std::move(b);
+      return node;
+    }
+
+    std::unique_ptr<Node> parseOr(){
+      auto node = parseAnd();
+      while (acceptSymbol("||") || acceptKeyword("OR")) node = binary(Node::kOr, std::move(node), parseAnd());
+      return node;
+    }
+
+    std::unique_ptr<Node> parseAnd(){
+      auto node = parseFactor();
+      while (acceptSymbol("&&") || acceptKeyword("AND")) node = binary(Node::kAnd, std::move(node), parseFactor());
+      return node;
+    }
+
+    std::unique_ptr<Node> parseFactor(){
+      if (acceptSymbol("!") || acceptKeyword("NOT")){
+        auto node = std::make_unique<Node>();
+        node->kind = Node::kNot;
+        node->a = parseFactor();
+        return node;
+      }
+      if (acceptSymbol("(")){
+        auto node = parseOr();
+        if (!acceptSymbol(")")) fail("expected ')'");
+        return node;
+      }
+      return parseAtom();
+    }
+
+    std::unique_ptr<Node> parseAtom(){
+      std::string_view name = peekWord();
+      if (name.empty()) fail("expected an algorithm name");
+      fPos += name.size();
+
+      auto node = std::make_unique<Node>();
+      node->kind = Node::kPass;
+      if (iequals(name, "prescale") || iequals(name, "passed")){
+        Node::Kind kind = iequals(name, "prescale") ? Node::kPrescale : Node::kPass;
+        if (acceptSymbol("(")){
+          node->kind = kind;
+          name = peekWord();
+          if (name.empty()) fail("expected an algorithm name");
+          fPos += name.size();
+          if (!acceptSymbol(")")) fail("expected ')'");
+        }
+        else if (!peekWord().empty() && !isKeyword(peekWord())){
+          // "passed NAME" / "prescale NAME"; otherwise the word is itself an algorithm name
+          node->kind = kind;
+          name = peekWord();
+          fPos += name.size();
+        }
+      }
+      auto it = std::find(fMenu.begin(), fMenu.end(), name);
+      if (it == fMenu.end()) fail("unknown algorithm '" + std::string(name) + "'");
+      node->index = it - fMenu.begin();
+      return node;
+    }
+
+    std::string_view fText;
+    std::size_t fPos;
+    const std::vector<std::string>& fMenu;
+  };
+
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerSelection::TriggerSelection(std::string_view expression, const std::vector<std::string>& menu)
+  : fExpression(expression), fMenu(menu), fMenuHash(TriggerNameTable::menuHash(menu)) {
+  compile();
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::TriggerSelection::TriggerSelection(std::string_view expression, const ubdaqSoftwareTriggerData& reference)
+  : fExpression(expression), fMenu(reference.getListOfAlgorithms()), fMenuHash(reference.getMenuHash()) {
+  compile();
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::TriggerSelection::compile(){
+  if (fMenu.size() > kMaxAlgorithms){
+    throw std::invalid_argument("TriggerSelection: menus with more than 64 algorithms are not supported");
+  }
+  std::unique_ptr<Node> root = Parser(fExpression, fMenu).parse();
+
+  // disjunctive normal form with negations pushed down to the literals
+  struct Dnf {
+    static std::vector<Term> build(const Node& node, bool neg){
+      switch (node.kind){
+      case Node::kPass:
+      case Node::kPrescale: {
+        Term t;
+        uint64_t bit = uint64_t(1) << node.index;
+        uint64_t& word = node.kind == Node::kPass ? (neg ? t.passOff : t.passOn) : (neg ? t.prescaleOff : t.prescaleOn);
+        word = bit;
+        return std::vector<Term>(1, t);
+      }
+      case Node::kNot:
+        return build(*node.a, !neg);
+      default:
+        break;
+      }
+      std::vector<Term> a = build(*node.a, neg);
+      std::vector<Term> b = build(*node.b, neg);
+      // AND, or OR under a negation (De Morgan), is a cross product; the other case a union
+      if ((node.kind == Node::kAnd) != neg){
+        std::vector<Term> out;
+        for (auto const& x: a){
+          for (auto const& y: b){
+            Term t;
+            t.passOn = x.passOn | y.passOn;
+            t.passOff = x.passOff | y.passOff;
+            t.prescaleOn = x.prescaleOn | y.prescaleOn;
+            t.prescaleOff = x.prescaleOff | y.prescaleOff;
+            if ((t.passOn & t.passOff) || (t.prescaleOn & t.prescaleOff)) continue; // never true
+            out.push_back(t);
+            if (out.size() > kMaxTerms){
+              throw std::invalid_argument("TriggerSelection: expression expands to too many terms");
+            }
+          }
+        }
+        return out;
+      }
+      a.insert(a.end(), b.begin(), b.end());
+      return a;
+    }
+  };
+  fTerms = Dnf::build(*root, false);
+
+  uint64_t used = 0;
+  for (auto const& t: fTerms){
+    used |= t.passOn | t.passOff | t.prescaleOn | t.prescaleOff;
+  }
+  fUsed.clear();
+  for (unsigned int i(0); i < fMenu.size(); ++i){
+    if ((used >> i) & 1) fUsed.push_back(i);
+  }
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerSelection::evaluate(uint64_t pass, uint64_t prescale) const{
+  for (auto const& t: fTerms){
+    if ((pass & t.passOn) == t.passOn && !(pass & t.passOff) &&
+        (prescale & t.prescaleOn) == t.prescaleOn && !(prescale & t.prescaleOff)){
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerSelection::evaluate(const ubdaqSoftwareTriggerData& event) const{
+  // a detached event from another menu has no names to remap through;
+  // reading every algorithm as "not passed" would make NOT terms true.
+  if (!event.hasMenu() && event.getMenuHash() != fMenuHash){
+    throw std::logic_error("TriggerSelection: event has no trigger menu and its menu differs from the selection's;"
+                           " evaluate the view from ubdaqSoftwareTriggerData::resolve() instead");
+  }
+  return evaluate(event, event.getMenu());
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerSelection::evaluate(const ubdaqSoftwareTriggerView& event) const{
+  return evaluate(event.data(), event.menu());
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::TriggerSelection::evaluate(const ubdaqSoftwareTriggerData& event, const ubdaqSoftwareTriggerMenu& names) const{
+  if (event.getMenuHash() == fMenuHash){
+    return evaluate(event.getPassBits(), event.getPassPrescaleBits());
+  }
+
+  // different menu: gather only the bits the expression uses, by name.
+  // An algorithm missing from this event counts as not passed.
+  uint64_t pass = 0, prescale = 0;
+  for (int i: fUsed){
+    int id = names.find(fMenu[i]);
+    if (id < 0) continue;
+    pass |= uint64_t(event.getPass(id)) << i;
+    prescale |= uint64_t(event.getPassPrescale(id)) << i;
+  }
+  return evaluate(pass, prescale);
+}
@@ -0,0 +1,75 @@
+#ifndef _UBOONETYPES_TRIGGERSELECTION_H
+#define _UBOONETYPES_TRIGGERSELECTION_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ubobj/Trigger/ubdaqSoftwareTriggerData.h"
+
+namespace raw{
+
+// Precompiled boolean selection over software trigger decisions.
+//
+// Grammar (keywords are case-insensitive):
+//   expr   := term { (OR | "||") term }
+//   term   := factor { (AND | "&&") factor }
+//   factor := (NOT | "!") factor | "(" expr ")" | atom
+//   atom   := NAME | passed(NAME) | passed NAME | prescale(NAME) | prescale NAME
+// A bare NAME means "passed NAME"; prescale(NAME) means "passed NAME's prescale".
+// An algorithm may itself be called passed or prescale as long as no name follows it.
+// e.g. "EXT_BNB_unbiased OR (BNB_FEMBeamTriggerAlgo AND prescale(BNB_FEMBeamTriggerAlgo))"
+//      "passed EXT_BNB_unbiased AND NOT prescale BNB_FEMBeamTriggerAlgo"
+//
+// The expression is parsed once, names are resolved to indices in a
+// reference menu, and the result is flattened to an OR of AND-terms over
+// the pass and prescale bit masks. Evaluating an event is then a few mask
+// compares. Events whose menu differs from the reference are remapped by
+// name. Menus are limited to 64 algorithms.
+// Parse errors and unknown names throw std::invalid_argument. Evaluating a
+// detached event (menu stored per run) whose menu differs from the reference
+// throws std::logic_error: resolve() it against its run's menu and evaluate
+// the view instead.
+class TriggerSelection {
+
+ public:
+  TriggerSelection(std::string_view expression, const std::vector<std::string>& menu);
+  TriggerSelection(std::string_view expression, const ubdaqSoftwareTriggerData& reference);
+
+  bool operator()(const ubdaqSoftwareTriggerData& event) const { return evaluate(event); }
+  bool operator()(const ubdaqSoftwareTriggerView& event) const { return evaluate(event); }
+  bool evaluate(const ubdaqSoftwareTriggerData& event) const;
+  bool evaluate(const ubdaqSoftwareTriggerView& event) const; // events whose menu is stored per run
+  bool evaluate(uint64_t pass, uint64_t prescale) const; // masks index-aligned with the reference menu
+
+  const std::string& expression() const { return fExpression; }
+  const std::vector<std::string>& menu() const { return fMenu; }
+  uint64_t menuHash() const { return fMenuHash; }
+  std::size_t nTerms() const { return fTerms.size(); }
+
+  static constexpr std::size_t kMaxAlgorithms = 64;
+  static constexpr std::size_t kMaxTerms = 1024;
+
+ private:
+  // one conjunction: every "on" bit set and every "off" bit clear
+  struct Term {
+    uint64_t passOn = 0;
+    uint64_t passOff = 0;
+    uint64_t prescaleOn = 0;
+    uint64_t prescaleOff = 0;
+  };
+
+  void compile();
+  bool evaluate(const ubdaqSoftwareTriggerData& event, const ubdaqSoftwareTriggerMenu& names) const;
+
+  std::string fExpression;
+  std::vector<std::string> fMenu;
+  uint64_t fMenuHash;
+  std::vector<Term> fTerms;
+  std::vector<int> fUsed; // menu indices the expression refers to
+
+};
+
+}  // end of namespace raw
+
+#endif
@@ -0,0 +1,48 @@
+
+#include <algorithm>
+#include "UBTriggerWord.h"
+
+//-----------------------------------------------------------------------------------
+
+std::size_t trigger::countMatching(const uint32_t* words, std::size_t n, UBTriggerWord mask){
+  const uint32_t m = mask.value();
+  std::size_t count = 0;
+  for (std::size_t i(0); i < n; ++i){
+    count += (words[i] & m) != 0;
+  }
+  return count;
+}
+
+//-----------------------------------------------------------------------------------
+
+std::size_t trigger::countMatching(const std::vector<UBTriggerWord>& words, UBTriggerWord mask){
+  return countMatching(reinterpret_cast<const uint32_t*>(words.data()), words.size(), mask);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::array<uint64_t,32> trigger::countPerBit(const uint32_t* words, std::size_t n){
+  std::array<uint64_t,32> counts{};
+  // 32-bit lane counters vectorize well; flush them before they could overflow
+  const std::size_t kBlock = 1u << 20;
+  for (std::size_t start(0); start < n; start += kBlock){
+    uint32_t lanes[32] = {};
+    std::size_t end = std::min(n, start + kBlock);
+    for (std::size_t i(start); i < end; ++i){
+      const uint32_t w = words[i];
+      for (unsigned int b(0); b < 32; ++b){
+        lanes[b] += (w >> b) & 1;
+      }
+    }
+    for (unsigned int b(0); b < 32; ++b){
+      counts[b] += lanes[b];
+    }
+  }
+  return counts;
+}
+
+//-----------------------------------------------------------------------------------
+
+std::array<uint64_t,32> trigger::countPerBit(const std::vector<UBTriggerWord>& words){
+  return countPerBit(reinterpret_cast<const uint32_t*>(words.data()), words.size());
+}
@@ -0,0 +1,69 @@
+#ifndef UBTRIGGERWORD_H
+#define UBTRIGGERWORD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "ubobj/Trigger/UBTriggerTypes.h"
+
+namespace trigger{
+
+  // The hardware trigger word (raw::Trigger::TriggerBits()) with the UBTrigger_t
+  // bit positions as its only vocabulary, so consumers stop hand-rolling
+  // shifts and masks:
+  //
+  //   UBTriggerWord word(trig.TriggerBits());
+  //   if (word.any(TriggerMask<kTriggerBNB, kTriggerNuMI>)) ...
+  //
+  class UBTriggerWord {
+
+  public:
+    constexpr UBTriggerWord() : fBits(0) {}
+    constexpr explicit UBTriggerWord(uint32_t bits) : fBits(bits) {}
+
+    static constexpr UBTriggerWord bit(UBTrigger_t b) { return UBTriggerWord(uint32_t(1) << b); }
+
+    constexpr uint32_t value() const { return fBits; }
+    constexpr bool test(UBTrigger_t b) const { return (fBits >> b) & 1; }
+    constexpr bool any(UBTriggerWord mask) const { return (fBits & mask.fBits) != 0; }
+    constexpr bool all(UBTriggerWord mask) const { return (fBits & mask.fBits) == mask.fBits; }
+    constexpr bool none(UBTriggerWord mask) const { return !any(mask); }
+    constexpr bool empty() const { return fBits == 0; }
+
+    constexpr UBTriggerWord set(UBTrigger_t b) const { return UBTriggerWord(fBits | (uint32_t(1) << b)); }
+    constexpr UBTriggerWord reset(UBTrigger_t b) const { return UBTriggerWord(fBits & ~(uint32_t(1) << b)); }
+
+    friend constexpr UBTriggerWord operator|(UBTriggerWord a, UBTriggerWord b) { return UBTriggerWord(a.fBits | b.fBits); }
+    friend constexpr UBTriggerWord operator&(UBTriggerWord a, UBTriggerWord b) { return UBTriggerWord(a.fBits & b.fBits); }
+    friend constexpr UBTriggerWord operator~(UBTriggerWord a) { return UBTriggerWord(~a.fBits); }
+    friend constexpr bool operator==(UBTriggerWord a, UBTriggerWord b) { return a.fBits == b.fBits; }
+    friend constexpr bool operator!=(UBTriggerWord a, UBTriggerWord b) { return a.fBits != b.fBits; }
+
+  private:
+    uint32_t fBits;
+
+  };
+
+  static_assert(sizeof(UBTriggerWord) == sizeof(uint32_t) && std::is_standard_layout<UBTriggerWord>::value,
+                "UBTriggerWord must overlay a raw trigger word");
+
+  // mask with the given bits set, composed at compile time
+  template <UBTrigger_t... Bits>
+  inline constexpr UBTriggerWord TriggerMask = UBTriggerWord(((uint32_t(1) << Bits) | ... | uint32_t(0)));
+
+  // common stream masks
+  inline constexpr UBTriggerWord kBNBMask  = TriggerMask<kTriggerBNB>;
+  inline constexpr UBTriggerWord kNuMIMask = TriggerMask<kTriggerNuMI>;
+  inline constexpr UBTriggerWord kEXTMask  = TriggerMask<kTriggerEXT>;
+
+  // Counting over arrays of trigger words, written as branch-free loops the
+  // compiler vectorizes. The uint32_t overloads take raw TriggerBits() values.
+  std::size_t countMatching(const uint32_t* words, std::size_t n, UBTriggerWord mask); // words with any bit of mask set
+  std::size_t countMatching(const std::vector<UBTriggerWord>& words, UBTriggerWord mask);
+  std::array<uint64_t,32> countPerBit(const uint32_t* words, std::size_t n); // entry b counts words with bit b set
+  std::array<uint64_t,32> countPerBit(const std::vector<UBTriggerWord>& words);
+
+}
+#endif
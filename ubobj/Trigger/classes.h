@@ -9,7 +9,9 @@
 //
 
 #include "canvas/Persistency/Common/Wrapper.h"
+#include "ubobj/Trigger/TriggerCountAccumulator.h"
 #include "ubobj/Trigger/ubdaqSoftwareTriggerData.h"
+#include "ubobj/Trigger/ubdaqSoftwareTriggerMenu.h"
 
 //
 // Only include objects that we would like to be able to put into the event.
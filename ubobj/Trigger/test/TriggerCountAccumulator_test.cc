@@ -0,0 +1,130 @@
+/**
+ * \file TriggerCountAccumulator_test.cc
+ *
+ * \brief Unit test of raw::KahanSum and raw::TriggerCountAccumulator:
+ * compensated sums and their merge, prescale-weighted counts over menus,
+ * detached events, and merge/aggregate/copy
+ *
+ */
+
+#define BOOST_TEST_MODULE ( TriggerCountAccumulator_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/Trigger/TriggerCountAccumulator.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // one event of a two-algorithm menu
+  raw::ubdaqSoftwareTriggerData makeEvent(bool passA, bool prescaleA, bool passB, bool prescaleB, float weightA = 4, float weightB = 1)
+  {
+    raw::ubdaqSoftwareTriggerData event;
+    event.addAlgorithm("A", passA, prescaleA, 0, 0, 0, 0, weightA);
+    event.addAlgorithm("B", passB, prescaleB, 0, 0, 0, 0, weightB);
+    return event;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(kahan_keeps_small_terms)
+{
+  raw::KahanSum sum;
+  double naive = 1e16;
+  sum.add(1e16);
+  for (int i = 0; i < 10000; ++i) { sum.add(1.); naive += 1.; }
+  BOOST_TEST(naive == 1e16);
+  BOOST_TEST(sum.value() == 1e16 + 10000.);
+
+  // the larger-operand branch: a small running sum meeting a big term
+  raw::KahanSum mixed;
+  mixed.add(1.);
+  mixed.add(1e100);
+  mixed.add(1.);
+  mixed.add(-1e100);
+  BOOST_TEST(mixed.value() == 2.);
+
+  // halves summed separately merge to the same value
+  raw::KahanSum a, b;
+  a.add(1e16);
+  for (int i = 0; i < 5000; ++i) { a.add(1.); b.add(1.); }
+  a.merge(b);
+  BOOST_TEST(a.value() == 1e16 + 10000.);
+}
+
+BOOST_AUTO_TEST_CASE(weighted_counts)
+{
+  raw::TriggerCountAccumulator acc;
+  acc.fill(makeEvent(true, true, false, true));
+  acc.fill(makeEvent(true, false, true, true));
+  acc.fill(makeEvent(true, true, true, true));
+
+  BOOST_TEST(acc.getNumberOfEvents() == 3u);
+  BOOST_CHECK(acc.getListOfAlgorithms() == (std::vector<std::string>{ "A", "B" }));
+  const auto& a = acc.getCounts("A");
+  BOOST_TEST(a.nPresent == 3u);
+  BOOST_TEST(a.nPassed == 3u);
+  BOOST_TEST(a.nPassedPrescale == 2u);
+  BOOST_TEST(a.nPassedBoth == 2u);
+  BOOST_TEST(acc.getWeightedCount("A") == 8.);
+  BOOST_TEST(acc.getWeightedCountError("A") == std::sqrt(32.));
+  BOOST_TEST(acc.getWeightedCount("B") == 2.);
+  BOOST_TEST(acc.getCounts("C").nPresent == 0u);
+
+  // a new prescale weight for the same names is a menu of its own
+  acc.fill(makeEvent(true, true, false, false, 10));
+  BOOST_TEST(acc.getWeightedCount("A") == 18.);
+}
+
+BOOST_AUTO_TEST_CASE(detached_events)
+{
+  raw::TriggerCountAccumulator acc;
+  raw::ubdaqSoftwareTriggerData detached = makeEvent(true, true, false, false);
+  const raw::ubdaqSoftwareTriggerMenu menu = detached.getMenu();
+  detached.detachMenu();
+
+  // content hash never seen: unresolved
+  acc.fill(detached);
+  BOOST_TEST(acc.getNumberOfUnresolvedEvents() == 1u);
+  BOOST_TEST(acc.getCounts("A").nPresent == 0u);
+
+  // counted through a view, then by hash once the menu is known
+  acc.fill(*detached.resolve(menu));
+  acc.fill(detached);
+  BOOST_TEST(acc.getNumberOfEvents() == 3u);
+  BOOST_TEST(acc.getNumberOfUnresolvedEvents() == 1u);
+  BOOST_TEST(acc.getWeightedCount("A") == 8.);
+
+  // other prescale weights give another content hash
+  raw::ubdaqSoftwareTriggerData reweighted = makeEvent(true, true, false, false, 5);
+  reweighted.detachMenu();
+  acc.fill(reweighted);
+  BOOST_TEST(acc.getNumberOfUnresolvedEvents() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(merge_aggregate_and_copy)
+{
+  raw::TriggerCountAccumulator t1, t2;
+  t1.fill(makeEvent(true, true, false, false));
+  t2.fill(makeEvent(true, true, true, true));
+  t2.fill(makeEvent(false, false, true, true));
+
+  raw::TriggerCountAccumulator total;
+  total.merge(t1);
+  total.aggregate(t2);
+  BOOST_TEST(total.getNumberOfEvents() == 3u);
+  BOOST_TEST(total.getWeightedCount("A") == 8.);
+  BOOST_TEST(total.getCounts("B").nPassedBoth == 2u);
+
+  // a copy has its own menu cache: filling it leaves the original alone
+  raw::TriggerCountAccumulator copy(t1);
+  copy.fill(makeEvent(true, true, false, false));
+  BOOST_TEST(copy.getWeightedCount("A") == 8.);
+  BOOST_TEST(t1.getWeightedCount("A") == 4.);
+
+  total.clear();
+  BOOST_TEST(total.getNumberOfEvents() == 0u);
+  BOOST_TEST(total.getListOfAlgorithms().empty());
+}
@@ -0,0 +1,143 @@
+/**
+ * \file TriggerSelection_test.cc
+ *
+ * \brief Unit test of raw::TriggerSelection: grammar, precedence, errors,
+ * the algorithm and term limits, and evaluation of events by name
+ *
+ */
+
+#define BOOST_TEST_MODULE ( TriggerSelection_test )
+#include "boost/test/unit_test.hpp"
+
+#include "ubobj/Trigger/TriggerSelection.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  const std::vector<std::string> kMenu{ "BNB", "EXT", "NUMI", "passed" };
+
+  // pass/prescale masks from bit strings, algorithm 0 first
+  uint64_t bits(const std::string& s)
+  {
+    uint64_t m = 0;
+    for (std::size_t i = 0; i < s.size(); ++i) if (s[i] == '1') m |= uint64_t(1) << i;
+    return m;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(atoms_and_keywords)
+{
+  raw::TriggerSelection bare("BNB", kMenu);
+  BOOST_TEST(bare.evaluate(bits("1000"), 0));
+  BOOST_TEST(!bare.evaluate(bits("0100"), 0));
+
+  // passed(NAME), passed NAME and a bare NAME are the same atom
+  for (const char* expr : { "passed(EXT)", "passed EXT", "PASSED EXT" }) {
+    raw::TriggerSelection s(expr, kMenu);
+    BOOST_TEST(s.evaluate(bits("0100"), 0));
+    BOOST_TEST(!s.evaluate(bits("1000"), bits("0100")));
+  }
+  for (const char* expr : { "prescale(EXT)", "prescale EXT", "Prescale EXT" }) {
+    raw::TriggerSelection s(expr, kMenu);
+    BOOST_TEST(s.evaluate(0, bits("0100")));
+    BOOST_TEST(!s.evaluate(bits("0100"), 0));
+  }
+
+  // keywords are case-insensitive, algorithm names are not
+  BOOST_CHECK_THROW(raw::TriggerSelection("passed ext", kMenu), std::invalid_argument);
+
+  // an algorithm called "passed" is a name when nothing follows it
+  raw::TriggerSelection named("passed", kMenu);
+  BOOST_TEST(named.evaluate(bits("0001"), 0));
+  raw::TriggerSelection namedAnd("passed AND BNB", kMenu);
+  BOOST_TEST(namedAnd.evaluate(bits("1001"), 0));
+  BOOST_TEST(!namedAnd.evaluate(bits("1000"), 0));
+}
+
+BOOST_AUTO_TEST_CASE(precedence_and_negation)
+{
+  // AND binds tighter than OR; NOT binds tighter than AND
+  raw::TriggerSelection s("BNB OR EXT AND NOT NUMI", kMenu);
+  BOOST_TEST(s.evaluate(bits("1000"), 0));
+  BOOST_TEST(s.evaluate(bits("0100"), 0));
+  BOOST_TEST(!s.evaluate(bits("0110"), 0));
+  BOOST_TEST(s.evaluate(bits("1110"), 0));
+
+  raw::TriggerSelection grouped("(BNB || EXT) && !NUMI", kMenu);
+  BOOST_TEST(!grouped.evaluate(bits("1010"), 0));
+  BOOST_TEST(grouped.evaluate(bits("1000"), 0));
+
+  // De Morgan through the flattening
+  raw::TriggerSelection demorgan("NOT (BNB OR prescale EXT)", kMenu);
+  BOOST_TEST(demorgan.evaluate(0, 0));
+  BOOST_TEST(!demorgan.evaluate(bits("1000"), 0));
+  BOOST_TEST(!demorgan.evaluate(0, bits("0100")));
+  BOOST_TEST(demorgan.evaluate(bits("0100"), bits("1000")));
+
+  raw::TriggerSelection contradiction("BNB AND NOT BNB", kMenu);
+  BOOST_TEST(!contradiction.evaluate(bits("1000"), 0));
+  BOOST_TEST(!contradiction.evaluate(0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(parse_errors)
+{
+  for (const char* expr : { "", "BNB AND", "(BNB", "BNB)", "BNB EXT", "NOT", "passed(BNB", "UNKNOWN", "BNB OR UNKNOWN" })
+    BOOST_CHECK_THROW(raw::TriggerSelection(expr, kMenu), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(limits)
+{
+  std::vector<std::string> big;
+  for (int i = 0; i < 65; ++i) big.push_back("A" + std::to_string(i));
+  BOOST_CHECK_THROW(raw::TriggerSelection("A0", big), std::invalid_argument);
+  big.pop_back();
+  BOOST_CHECK_NO_THROW(raw::TriggerSelection("A63", big));
+
+  // (A0 OR A1) AND (A2 OR A3) AND ... : 2^n terms once flattened
+  std::string expr;
+  for (int i = 0; i < 10; ++i) expr += (i ? " AND (" : "(") + big[2 * i] + " OR " + big[2 * i + 1] + ")";
+  raw::TriggerSelection fits(expr, big);
+  BOOST_TEST(fits.nTerms() == 1024u);
+  expr += " AND (" + big[20] + " OR " + big[21] + ")";
+  BOOST_CHECK_THROW(raw::TriggerSelection(expr, big), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(events_are_remapped_by_name)
+{
+  raw::TriggerSelection s("EXT AND NOT prescale BNB", kMenu);
+
+  // same names in another order, plus one the selection does not know
+  raw::ubdaqSoftwareTriggerData event;
+  event.addAlgorithm("OTHER", true, true, 0, 0, 0, 0, 1);
+  event.addAlgorithm("EXT", true, false, 0, 0, 0, 0, 1);
+  event.addAlgorithm("BNB", false, false, 0, 0, 0, 0, 1);
+  BOOST_TEST(s(event));
+
+  raw::ubdaqSoftwareTriggerData vetoed;
+  vetoed.addAlgorithm("BNB", false, true, 0, 0, 0, 0, 1);
+  vetoed.addAlgorithm("EXT", true, false, 0, 0, 0, 0, 1);
+  BOOST_TEST(!s(vetoed));
+}
+
+BOOST_AUTO_TEST_CASE(detached_events_need_their_menu)
+{
+  raw::TriggerSelection s("NOT BNB", kMenu);
+
+  raw::ubdaqSoftwareTriggerData event;
+  event.addAlgorithm("EXT", false, false, 0, 0, 0, 0, 1);
+  event.addAlgorithm("BNB", true, false, 0, 0, 0, 0, 1);
+  const raw::ubdaqSoftwareTriggerMenu menu = event.getMenu();
+  event.detachMenu();
+
+  // no names to remap through: refuse rather than read BNB as "not passed"
+  BOOST_CHECK_THROW(s(event), std::logic_error);
+
+  auto view = event.resolve(menu);
+  BOOST_TEST_REQUIRE(view.has_value());
+  BOOST_TEST(!s(*view));
+}
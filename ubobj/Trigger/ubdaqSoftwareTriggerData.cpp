@@ -1,68 +1,101 @@
 
 #include <time.h>
+#include <stdexcept>
 #include "ubdaqSoftwareTriggerData.h"
 
 //-----------------------------------------------------------------------------------
 
-raw::ubdaqSoftwareTriggerData::ubdaqSoftwareTriggerData() {
+raw::ubdaqSoftwareTriggerData::ubdaqSoftwareTriggerData()
+  : menuHash(TriggerNameTable::menuHash(std::vector<std::string>())), contentHash(menuHash) {
 
 }
 
 void raw::ubdaqSoftwareTriggerData::addAlgorithm(std::string name_, bool pass_, bool pass_prescale_, uint32_t phmax_, uint32_t multiplicity_, uint32_t triggerTick_, double triggerTime_, float prescale_){
-  std::pair<std::string, bool> tmp_pair;
-  std::pair<std::string, bool> tmp_pair_prescale;
-  tmp_pair.first = name_;
-  tmp_pair.second = pass_;
-  
-  passAlgo.push_back(tmp_pair);
-  passPrescale.push_back(pass_prescale_);
+  if (menu.getNumberOfAlgorithms() != getNumberOfAlgorithms()){
+    throw std::logic_error("ubdaqSoftwareTriggerData: cannot add trigger algorithm '" + name_ + "' after detachMenu()");
+  }
+  unsigned int i = PHMAX.size();
+  if (i % 64 == 0){
+    passBits.push_back(0);
+    prescaleBits.push_back(0);
+  }
+  passBits[i/64] |= uint64_t(pass_) << (i%64);
+  prescaleBits[i/64] |= uint64_t(pass_prescale_) << (i%64);
+
+  menu.addAlgorithm(std::move(name_), prescale_);
+  menuHash = menu.getMenuHash();
+  contentHash = menu.getContentHash();
+
   PHMAX.push_back(phmax_);
   multiplicity.push_back(multiplicity_);
   triggerTick.push_back(triggerTick_);
   triggerTime.push_back(triggerTime_);
-  prescale_weight.push_back(prescale_);
 }
 
 //-----------------------------------------------------------------------------------
 
 std::vector<std::string> raw::ubdaqSoftwareTriggerData::getListOfAlgorithms(void) const{
-  std::vector<std::string> list;
-  for (auto const & algoPair: passAlgo){
-    list.push_back(algoPair.first);
-  }
-  return list;
+  return getMenu().getListOfAlgorithms();
 }
 
 //-----------------------------------------------------------------------------------
 
 int raw::ubdaqSoftwareTriggerData::getNumberOfAlgorithms(void) const{
-  return passAlgo.size();
+  return PHMAX.size();
+}
+
+//-----------------------------------------------------------------------------------
+
+const raw::ubdaqSoftwareTriggerMenu& raw::ubdaqSoftwareTriggerData::getMenu() const{
+  static const ubdaqSoftwareTriggerMenu empty;
+  return hasMenu() ? menu : empty;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerData::hasMenu() const{
+  return menu.getNumberOfAlgorithms() == getNumberOfAlgorithms() && menu.getMenuHash() == menuHash;
 }
 
+//-----------------------------------------------------------------------------------
+
+std::optional<raw::ubdaqSoftwareTriggerView> raw::ubdaqSoftwareTriggerData::resolve(const ubdaqSoftwareTriggerMenu& menu_) const{
+  if (menu_.getContentHash() != contentHash || menu_.getNumberOfAlgorithms() != getNumberOfAlgorithms()){
+    return std::nullopt;
+  }
+  return ubdaqSoftwareTriggerView(*this, menu_);
+}
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::passedAlgo(std::string algo) const{
+void raw::ubdaqSoftwareTriggerData::detachMenu(){
+  menu = ubdaqSoftwareTriggerMenu();
+}
+
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerData::passedAlgo(std::string_view algo) const{
   int id = getID(algo);
   return getPass(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgo(std::string algo) const{
+bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgo(std::string_view algo) const{
   int id = getID(algo);
   return getPassPrescale(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::vetoAlgo(std::string algo) const{
+bool raw::ubdaqSoftwareTriggerData::vetoAlgo(std::string_view algo) const{
   return not passedAlgo(algo);
 }
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::passedAlgos(std::vector<std::string> algos) const{
+bool raw::ubdaqSoftwareTriggerData::passedAlgos(const std::vector<std::string>& algos) const{
   for (auto const &algo: algos){
     if (passedAlgo(algo)){
       return true;
@@ -74,7 +107,7 @@ bool raw::ubdaqSoftwareTriggerData::passedAlgos(std::vector<std::string> algos)
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgos(std::vector<std::string> algos) const{
+bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgos(const std::vector<std::string>& algos) const{
   for (auto const &algo: algos){
     if (passedPrescaleAlgo(algo)){
       return true;
@@ -86,45 +119,48 @@ bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgos(std::vector<std::string>
 
 //-----------------------------------------------------------------------------------
 
-bool raw::ubdaqSoftwareTriggerData::vetoAlgos(std::vector<std::string> algos) const{
+bool raw::ubdaqSoftwareTriggerData::vetoAlgos(const std::vector<std::string>& algos) const{
   return not passedAlgos(algos);
 }
 
 //-----------------------------------------------------------------------------------
 
-uint32_t raw::ubdaqSoftwareTriggerData::getPhmax(std::string algo) const{  // max adc sum at (software) trigger firing time
+uint32_t raw::ubdaqSoftwareTriggerData::getPhmax(std::string_view algo) const{  // max adc sum at (software) trigger firing time
   int id = getID(algo);
   return getPhmax(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-uint32_t raw::ubdaqSoftwareTriggerData::getMultiplicity(std::string algo) const{  // multiplicity at (software) trigger firing time
+uint32_t raw::ubdaqSoftwareTriggerData::getMultiplicity(std::string_view algo) const{  // multiplicity at (software) trigger firing time
   int id = getID(algo);
   return getMultiplicity(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-uint32_t raw::ubdaqSoftwareTriggerData::getTriggerTick(std::string algo) const{   // tick since the beam-gate opened
+uint32_t raw::ubdaqSoftwareTriggerData::getTriggerTick(std::string_view algo) const{   // tick since the beam-gate opened
   int id = getID(algo);
   return getTriggerTick(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-double raw::ubdaqSoftwareTriggerData::getTimeSinceTrigger(std::string algo) const{  // time since the event (hardware) trigger, in us
+double raw::ubdaqSoftwareTriggerData::getTimeSinceTrigger(std::string_view algo) const{  // time since the event (hardware) trigger, in us
   int id = getID(algo);
   return getTimeSinceTrigger(id);
 }
 
 //-----------------------------------------------------------------------------------
 
-int raw::ubdaqSoftwareTriggerData::getID(std::string algo) const{
-  for (unsigned int i(0); i < passAlgo.size(); ++i){
-    if (passAlgo.at(i).first == algo){ // correct algorithm
-      return i;
-    }
+int raw::ubdaqSoftwareTriggerData::getID(std::string_view algo) const{
+  if (!hasMenu()){
+    std::cout << "WARNING - asked for a trigger algorithm by name without a trigger menu; use resolve() with the run's menu!" << std::endl;
+    return -999;
+  }
+  int id = getMenu().find(algo);
+  if (id >= 0){
+    return id;
   }
   std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
   return -999;
@@ -132,7 +168,62 @@ int raw::ubdaqSoftwareTriggerData::getID(std::string algo) const{
 
 //-----------------------------------------------------------------------------------
 
-float raw::ubdaqSoftwareTriggerData::getPrescale(std::string algo) const{
+uint64_t raw::ubdaqSoftwareTriggerData::getMenuHash() const{
+  return menuHash;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::ubdaqSoftwareTriggerData::getContentHash() const{
+  return contentHash;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::ubdaqSoftwareTriggerData::getPassBits() const{
+  return passBits.empty() ? 0 : passBits[0];
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::ubdaqSoftwareTriggerData::getPassPrescaleBits() const{
+  return prescaleBits.empty() ? 0 : prescaleBits[0];
+}
+
+//-----------------------------------------------------------------------------------
+
+raw::ubdaqSoftwareTriggerData::AlgoHandle raw::ubdaqSoftwareTriggerData::getHandle(std::string_view algo) const{
+  AlgoHandle handle;
+  handle.name = std::string(algo);
+  handle.index = hasMenu() ? getMenu().find(algo) : -1;
+  handle.menu = menuHash;
+  return handle;
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::ubdaqSoftwareTriggerData::getID(const AlgoHandle& algo) const{
+  if (algo.menu == menuHash && algo.index >= 0){ // same menu: the index still holds
+    return algo.index;
+  }
+  return getID(std::string_view(algo.name));
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerData::passedAlgo(const AlgoHandle& algo) const{
+  return getPass(getID(algo));
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerData::passedPrescaleAlgo(const AlgoHandle& algo) const{
+  return getPassPrescale(getID(algo));
+}
+
+//-----------------------------------------------------------------------------------
+
+float raw::ubdaqSoftwareTriggerData::getPrescale(std::string_view algo) const{
   int id = getID(algo);
   return getPrescale(id);
 }
@@ -141,11 +232,11 @@ float raw::ubdaqSoftwareTriggerData::getPrescale(std::string algo) const{
 
 bool raw::ubdaqSoftwareTriggerData::getPass(int i) const { 
   if (i >= 0){
-    if ((unsigned)i >= passAlgo.size()){
+    if ((unsigned)i >= PHMAX.size()){
       std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
       return 0;
     }
-    return passAlgo.at(i).second;
+    return testBit(passBits, i);
   }
   std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl; // negative index;
   return 0;
@@ -154,11 +245,11 @@ bool raw::ubdaqSoftwareTriggerData::getPass(int i) const {
 
 bool raw::ubdaqSoftwareTriggerData::getPassPrescale(int i) const { 
   if (i >= 0){
-    if ((unsigned)i >= passAlgo.size()){
+    if ((unsigned)i >= PHMAX.size()){
       std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
       return 0;
     }
-    return passPrescale.at(i);
+    return testBit(prescaleBits, i);
   }
   std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl; // negative index;
   return 0;
@@ -226,11 +317,11 @@ double raw::ubdaqSoftwareTriggerData::getTimeSinceTrigger(int i) const{
 
 std::string raw::ubdaqSoftwareTriggerData::getTriggerAlgorithm(int i) const{
   if (i >= 0){
-    if ((unsigned)i >= passAlgo.size()){
+    if ((unsigned)i >= (unsigned)getMenu().getNumberOfAlgorithms()){
       std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
       return "";
     }
-    return passAlgo.at(i).first;
+    return getMenu().getAlgorithmName(i);
   }
   std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl; // negative index
   return "";
@@ -240,13 +331,187 @@ std::string raw::ubdaqSoftwareTriggerData::getTriggerAlgorithm(int i) const{
 
 float raw::ubdaqSoftwareTriggerData::getPrescale(int i) const{
   if (i >= 0){
-    if ((unsigned)i >= prescale_weight.size()){
+    if ((unsigned)i >= (unsigned)getMenu().getNumberOfAlgorithms()){
       std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
       return 1;
     }
-    return prescale_weight.at(i);
+    return getMenu().getPrescale(i);
   }
   std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl; // negative index
   return 1;
 }
 
+//-----------------------------------------------------------------------------------
+
+std::optional<int> raw::ubdaqSoftwareTriggerData::findID(std::string_view algo, TriggerLookupTracker* tracker) const{
+  int id = hasMenu() ? getMenu().find(algo) : -1;
+  if (id < 0){
+    if (tracker) tracker->miss();
+    return std::nullopt;
+  }
+  return id;
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPass(int i) const{
+  if (i < 0 || (unsigned)i >= PHMAX.size()) return std::nullopt;
+  return testBit(passBits, i);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPassPrescale(int i) const{
+  if (i < 0 || (unsigned)i >= PHMAX.size()) return std::nullopt;
+  return testBit(prescaleBits, i);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<uint32_t> raw::ubdaqSoftwareTriggerData::tryPhmax(int i) const{
+  if (i < 0 || (unsigned)i >= PHMAX.size()) return std::nullopt;
+  return PHMAX[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<uint32_t> raw::ubdaqSoftwareTriggerData::tryMultiplicity(int i) const{
+  if (i < 0 || (unsigned)i >= multiplicity.size()) return std::nullopt;
+  return multiplicity[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<uint32_t> raw::ubdaqSoftwareTriggerData::tryTriggerTick(int i) const{
+  if (i < 0 || (unsigned)i >= triggerTick.size()) return std::nullopt;
+  return triggerTick[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<double> raw::ubdaqSoftwareTriggerData::tryTimeSinceTrigger(int i) const{
+  if (i < 0 || (unsigned)i >= triggerTime.size()) return std::nullopt;
+  return triggerTime[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<float> raw::ubdaqSoftwareTriggerData::tryPrescale(int i) const{
+  const ubdaqSoftwareTriggerMenu& m = getMenu();
+  if (i < 0 || i >= m.getNumberOfAlgorithms()) return std::nullopt;
+  return m.getPrescale(i);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPassedAlgo(std::string_view algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return tryPass(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPassedPrescaleAlgo(std::string_view algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return tryPassPrescale(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<int> raw::ubdaqSoftwareTriggerData::findID(const AlgoHandle& algo, TriggerLookupTracker* tracker) const{
+  if (algo.menu == menuHash && algo.index >= 0){ // same menu: the index still holds
+    return algo.index;
+  }
+  return findID(std::string_view(algo.name), tracker);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPassedAlgo(const AlgoHandle& algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return tryPass(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerData::tryPassedPrescaleAlgo(const AlgoHandle& algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return tryPassPrescale(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::ubdaqSoftwareTriggerView::getID(std::string_view algo) const{
+  int id = fMenu->find(algo);
+  if (id >= 0){
+    return id;
+  }
+  std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
+  return -999;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerView::passedAlgo(std::string_view algo) const{
+  return fData->getPass(getID(algo));
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerView::passedPrescaleAlgo(std::string_view algo) const{
+  return fData->getPassPrescale(getID(algo));
+}
+
+//-----------------------------------------------------------------------------------
+
+float raw::ubdaqSoftwareTriggerView::getPrescale(std::string_view algo) const{
+  return getPrescale(getID(algo));
+}
+
+//-----------------------------------------------------------------------------------
+
+float raw::ubdaqSoftwareTriggerView::getPrescale(int i) const{
+  if (i < 0 || i >= fMenu->getNumberOfAlgorithms()){
+    std::cout << "WARNING - asked for information on a trigger algorithm that isn't present!" << std::endl;
+    return 1;
+  }
+  return fMenu->getPrescale(i);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<int> raw::ubdaqSoftwareTriggerView::findID(std::string_view algo, TriggerLookupTracker* tracker) const{
+  int id = fMenu->find(algo);
+  if (id < 0){
+    if (tracker) tracker->miss();
+    return std::nullopt;
+  }
+  return id;
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerView::tryPassedAlgo(std::string_view algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return fData->tryPass(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<bool> raw::ubdaqSoftwareTriggerView::tryPassedPrescaleAlgo(std::string_view algo, TriggerLookupTracker* tracker) const{
+  auto id = findID(algo, tracker);
+  if (!id) return std::nullopt;
+  return fData->tryPassPrescale(*id);
+}
+
+//-----------------------------------------------------------------------------------
+
+std::optional<float> raw::ubdaqSoftwareTriggerView::tryPrescale(int i) const{
+  if (i < 0 || i >= fMenu->getNumberOfAlgorithms()) return std::nullopt;
+  return fMenu->getPrescale(i);
+}
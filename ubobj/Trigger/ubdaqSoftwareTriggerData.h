@@ -3,30 +3,95 @@
 #include <sys/types.h>
 #include <inttypes.h>
 //#include "evttypes.h"
+#include <atomic>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include "ubobj/Trigger/UBTriggerTypes.h"
+#include "ubobj/Trigger/ubdaqSoftwareTriggerMenu.h"
 
 namespace raw{
 
+// Per-event software trigger decisions.
+//
+// Algorithm names and prescale weights live in a ubdaqSoftwareTriggerMenu.
+// By default the menu is stored inside each event, as before. A writer that
+// stores the menu once per run/subrun calls detachMenu() before putting the
+// event product, which leaves only the menu hashes, the pass/prescale bits and
+// the numeric columns. Readers of such events pair the (const) event with the
+// run's menu through resolve(), which checks the content hash, so a menu with
+// the right names but other prescale weights is refused. getMenuHash(),
+// getContentHash(), getPass(i) and the bit accessors work without a menu.
+class ubdaqSoftwareTriggerView;
+
+// Count of name lookups that found no such algorithm, owned by the caller
+// (e.g. one per module, reported at endJob) and passed to the quiet getters.
+// Lookups without a tracker are not counted, so events never share a counter.
+class TriggerLookupTracker {
+
+ public:
+  TriggerLookupTracker() : fMissing(0) {}
+  TriggerLookupTracker(const TriggerLookupTracker&) = delete;
+  TriggerLookupTracker& operator=(const TriggerLookupTracker&) = delete;
+
+  void miss() { fMissing.fetch_add(1, std::memory_order_relaxed); } // relaxed: safe to share between a module's threads
+  uint64_t getMissingLookups() const { return fMissing.load(std::memory_order_relaxed); }
+  void reset() { fMissing.store(0, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> fMissing;
+
+};
+
 class ubdaqSoftwareTriggerData {
 
  public:
   ubdaqSoftwareTriggerData(); // standard constructor
 
+  // an algorithm name resolved against one trigger menu (ordered list of algorithm names).
+  // Lookups through a handle cost an integer compare while the menu is unchanged,
+  // and fall back to a name lookup when it differs.
+  struct AlgoHandle {
+    std::string name;
+    int index = -1;
+    uint64_t menu = 0;
+  };
+
+  // throws std::logic_error after detachMenu(): the names and weights would have nowhere to go
   void addAlgorithm(std::string name, bool pass, bool pass_prescale, uint32_t phmax, uint32_t multiplicity, uint32_t triggerTick, double triggerTime, float prescale);
 
   int getNumberOfAlgorithms(void) const;
   std::vector<std::string> getListOfAlgorithms(void) const;
+
+  // trigger menu (algorithm names and prescale weights)
+  const ubdaqSoftwareTriggerMenu& getMenu() const; // embedded menu, else an empty menu
+  bool hasMenu() const; // the menu is embedded
+  void detachMenu(); // drop the embedded menu, keeping only its hashes
+  // this event seen through menu (typically the run's); std::nullopt unless menu's
+  // content hash (names and prescale weights) is the one these decisions were made with
+  std::optional<ubdaqSoftwareTriggerView> resolve(const ubdaqSoftwareTriggerMenu& menu) const;
   
   // pass/veto by name
-  bool passedAlgo(std::string algo) const; // passed this algorithm
-  bool passedPrescaleAlgo(std::string algo) const; // passed this algorithms prescale
-  bool vetoAlgo(std::string algo) const; // NOT passAlgo
-  bool passedAlgos(std::vector<std::string> algos) const; // passed any on a list of these algorithms
-  bool vetoAlgos(std::vector<std::string> algos) const; // NOT passedAlgos
-  bool passedPrescaleAlgos(std::vector<std::string> algos) const; //passed any on a list of these prescales
+  bool passedAlgo(std::string_view algo) const; // passed this algorithm
+  bool passedPrescaleAlgo(std::string_view algo) const; // passed this algorithms prescale
+  bool vetoAlgo(std::string_view algo) const; // NOT passAlgo
+  bool passedAlgos(const std::vector<std::string>& algos) const; // passed any on a list of these algorithms
+  bool vetoAlgos(const std::vector<std::string>& algos) const; // NOT passedAlgos
+  bool passedPrescaleAlgos(const std::vector<std::string>& algos) const; //passed any on a list of these prescales
+
+  // pass/veto by handle
+  AlgoHandle getHandle(std::string_view algo) const; // resolve a name against this menu
+  int getID(const AlgoHandle& algo) const;
+  bool passedAlgo(const AlgoHandle& algo) const;
+  bool passedPrescaleAlgo(const AlgoHandle& algo) const;
+  uint64_t getMenuHash() const; // identifies the ordered list of algorithm names
+  uint64_t getContentHash() const; // ubdaqSoftwareTriggerMenu::getContentHash(): names and prescale weights
+
+  // pass/prescale decisions of the first 64 algorithms as bit masks, bit i = algorithm i
+  uint64_t getPassBits() const;
+  uint64_t getPassPrescaleBits() const;
 
   //getters by entry index
   bool getPass(int i) const;
@@ -39,22 +104,79 @@ class ubdaqSoftwareTriggerData {
   float getPrescale(int i) const;
 
   //getters by name
-  uint32_t getPhmax(std::string algo) const;  // max adc sum at (software) trigger firing time
-  uint32_t getMultiplicity(std::string algo) const;  // multiplicity at (software) trigger firing time
-  uint32_t getTriggerTick(std::string algo) const;   // tick since the beam-gate opened
-  double getTimeSinceTrigger(std::string algo) const;  // time since the event (hardware) trigger, in us
-  int getID(std::string algo) const; // get the index of a given algorithm
-  float getPrescale(std::string algo) const; // returns prescale_weight (see below)
+  uint32_t getPhmax(std::string_view algo) const;  // max adc sum at (software) trigger firing time
+  uint32_t getMultiplicity(std::string_view algo) const;  // multiplicity at (software) trigger firing time
+  uint32_t getTriggerTick(std::string_view algo) const;   // tick since the beam-gate opened
+  double getTimeSinceTrigger(std::string_view algo) const;  // time since the event (hardware) trigger, in us
+  int getID(std::string_view algo) const; // get the index of a given algorithm
+  float getPrescale(std::string_view algo) const; // returns the menu's prescale_weight (see ubdaqSoftwareTriggerMenu)
+
+  // quiet getters: std::nullopt instead of a WARNING and a sentinel, so hot loops
+  // do not contend on std::cout. Name misses are counted in tracker, if given.
+  // The handle versions never print, also when the handle falls back to its name.
+  std::optional<int> findID(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPass(int i) const;
+  std::optional<bool> tryPassPrescale(int i) const;
+  std::optional<uint32_t> tryPhmax(int i) const;
+  std::optional<uint32_t> tryMultiplicity(int i) const;
+  std::optional<uint32_t> tryTriggerTick(int i) const;
+  std::optional<double> tryTimeSinceTrigger(int i) const;
+  std::optional<float> tryPrescale(int i) const;
+  std::optional<bool> tryPassedAlgo(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPassedPrescaleAlgo(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<int> findID(const AlgoHandle& algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPassedAlgo(const AlgoHandle& algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPassedPrescaleAlgo(const AlgoHandle& algo, TriggerLookupTracker* tracker=nullptr) const;
 
  private:
 
-  std::vector<std::pair<std::string,bool> > passAlgo; // list of algorithms and corresponding bools for pass/fail
-  std::vector<bool> passPrescale; // list of algorithms and corresponding bools for pass/fail
+  friend class ubdaqSoftwareTriggerView;
+
+  static bool testBit(const std::vector<uint64_t>& bits, int i) { return (bits[i/64] >> (i%64)) & 1; }
+
+  uint64_t menuHash; // ubdaqSoftwareTriggerMenu::getMenuHash() of the menu these decisions belong to
+  uint64_t contentHash; // ubdaqSoftwareTriggerMenu::getContentHash() of the same menu
+  ubdaqSoftwareTriggerMenu menu; // algorithm names and prescale weights; empty once detached
+  std::vector<uint64_t> passBits; // pass/fail of algorithm i in bit i%64 of word i/64
+  std::vector<uint64_t> prescaleBits; // pass/fail of algorithm i's prescale, same layout
   std::vector<uint32_t> PHMAX; // max adc sum at (software) trigger firing time
   std::vector<uint32_t> multiplicity; // multiplicity at (software) trigger firing time
   std::vector<uint32_t> triggerTick; // tick since the beam-gate opened
   std::vector<double> triggerTime; // time since the event (hardware) trigger, in us
-  std::vector<float> prescale_weight; // 1/prescale_weight gives the fraction of events that are let through
+
+};
+
+// A const event paired with the menu its decisions were made with, for events
+// whose menu is stored per run. Made by ubdaqSoftwareTriggerData::resolve();
+// it refers to both objects, so it must not outlive either.
+class ubdaqSoftwareTriggerView {
+
+ public:
+  const ubdaqSoftwareTriggerData& data() const { return *fData; }
+  const ubdaqSoftwareTriggerMenu& menu() const { return *fMenu; }
+
+  int getNumberOfAlgorithms(void) const { return fMenu->getNumberOfAlgorithms(); }
+  const std::vector<std::string>& getListOfAlgorithms(void) const { return fMenu->getListOfAlgorithms(); }
+  std::string getTriggerAlgorithm(int i) const { return fMenu->getAlgorithmName(i); }
+
+  // by name, as on ubdaqSoftwareTriggerData: a missing name gives a WARNING and
+  // -999/false/1, or std::nullopt from the quiet versions
+  int getID(std::string_view algo) const;
+  bool passedAlgo(std::string_view algo) const;
+  bool passedPrescaleAlgo(std::string_view algo) const;
+  float getPrescale(std::string_view algo) const;
+  float getPrescale(int i) const;
+  std::optional<int> findID(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPassedAlgo(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<bool> tryPassedPrescaleAlgo(std::string_view algo, TriggerLookupTracker* tracker=nullptr) const;
+  std::optional<float> tryPrescale(int i) const;
+
+ private:
+  friend class ubdaqSoftwareTriggerData;
+  ubdaqSoftwareTriggerView(const ubdaqSoftwareTriggerData& data, const ubdaqSoftwareTriggerMenu& menu) : fData(&data), fMenu(&menu) {}
+
+  const ubdaqSoftwareTriggerData* fData;
+  const ubdaqSoftwareTriggerMenu* fMenu;
 
 };
 
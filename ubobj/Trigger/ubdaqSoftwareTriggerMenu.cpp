@@ -0,0 +1,76 @@
+
+#include <cstring>
+#include "ubdaqSoftwareTriggerMenu.h"
+
+//-----------------------------------------------------------------------------------
+
+raw::ubdaqSoftwareTriggerMenu::ubdaqSoftwareTriggerMenu()
+  : menuHash(TriggerNameTable::menuHash(std::vector<std::string>())) {
+
+}
+
+//-----------------------------------------------------------------------------------
+
+void raw::ubdaqSoftwareTriggerMenu::addAlgorithm(std::string name_, float prescale_){
+  menuHash = TriggerNameTable::combine(menuHash, name_);
+  algoNames.push_back(std::move(name_));
+  prescale_weight.push_back(prescale_);
+  nameIndex.reset();
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::ubdaqSoftwareTriggerMenu::getNumberOfAlgorithms(void) const{
+  return algoNames.size();
+}
+
+//-----------------------------------------------------------------------------------
+
+const std::vector<std::string>& raw::ubdaqSoftwareTriggerMenu::getListOfAlgorithms(void) const{
+  return algoNames;
+}
+
+//-----------------------------------------------------------------------------------
+
+bool raw::ubdaqSoftwareTriggerMenu::empty() const{
+  return algoNames.empty();
+}
+
+//-----------------------------------------------------------------------------------
+
+std::string raw::ubdaqSoftwareTriggerMenu::getAlgorithmName(int i) const{
+  if (i < 0 || (unsigned)i >= algoNames.size()) return "";
+  return algoNames[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+float raw::ubdaqSoftwareTriggerMenu::getPrescale(int i) const{
+  if (i < 0 || (unsigned)i >= prescale_weight.size()) return 1;
+  return prescale_weight[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+int raw::ubdaqSoftwareTriggerMenu::find(std::string_view algo) const{
+  return nameIndex.get(algoNames, menuHash).find(algo, algoNames);
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::ubdaqSoftwareTriggerMenu::getMenuHash() const{
+  return menuHash;
+}
+
+//-----------------------------------------------------------------------------------
+
+uint64_t raw::ubdaqSoftwareTriggerMenu::getContentHash() const{
+  // fold the prescale bit patterns into the name hash
+  uint64_t h = menuHash;
+  for (float w: prescale_weight){
+    uint32_t bits;
+    std::memcpy(&bits, &w, sizeof(bits));
+    h = (h ^ bits) * 1099511628211ULL;
+  }
+  return h;
+}
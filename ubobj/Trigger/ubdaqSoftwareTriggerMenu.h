@@ -0,0 +1,45 @@
+#ifndef _UBOONETYPES_DAQSWTRIGGERMENU_H
+#define _UBOONETYPES_DAQSWTRIGGERMENU_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ubobj/Trigger/TriggerNameIndex.h"
+
+namespace raw{
+
+// The software trigger menu: ordered algorithm names and their prescale weights.
+// The menu only changes at run boundaries, so writers store it once per
+// run/subrun and each event's ubdaqSoftwareTriggerData keeps only the menu
+// hash plus index-aligned pass/prescale bits.
+class ubdaqSoftwareTriggerMenu {
+
+ public:
+  ubdaqSoftwareTriggerMenu(); // standard constructor
+
+  void addAlgorithm(std::string name, float prescale);
+
+  int getNumberOfAlgorithms(void) const;
+  const std::vector<std::string>& getListOfAlgorithms(void) const;
+  bool empty() const;
+
+  std::string getAlgorithmName(int i) const; // "" if out of range
+  float getPrescale(int i) const; // 1 if out of range
+  int find(std::string_view algo) const; // index of algo, or -1; no warning
+  uint64_t getMenuHash() const; // identifies the ordered list of algorithm names
+  uint64_t getContentHash() const; // names and prescale weights; differs when only a prescale changes
+
+ private:
+
+  std::vector<std::string> algoNames; // algorithm names, in trigger data order
+  std::vector<float> prescale_weight; // 1/prescale_weight gives the fraction of events that are let through
+  uint64_t menuHash; // TriggerNameTable::menuHash(algoNames), kept up to date by addAlgorithm
+
+  TriggerNameIndex nameIndex; //! transient name -> index table, built on first lookup
+
+};
+
+}  // end of namespace raw
+
+#endif